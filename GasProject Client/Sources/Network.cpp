@@ -108,6 +108,17 @@ void Connection::parsePacket(Packet &packet) {
 		authUI->SetServerAnswer(false);
             break;
 	}
+	case ServerCommand::Code::GAME_LIST: {
+		sf::Int32 count;
+		packet >> count;
+		for (sf::Int32 i = 0; i < count; i++) {
+			sf::Int32 id, playersCount;
+			std::string title;
+			packet >> id >> title >> playersCount;
+			LOGI << "Game " << id << ": " << title << ", players: " << playersCount;
+		}
+		break;
+	}
         case ServerCommand::Code::GRAPHICS_UPDATE:
         {
             GameProcessUI *gameProcessUI = dynamic_cast<GameProcessUI *>(CC::Get()->GetWindow()->GetUI()->GetCurrentUIModule());
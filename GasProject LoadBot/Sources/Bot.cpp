@@ -0,0 +1,346 @@
+#include "Bot.hpp"
+
+#include <iterator>
+
+#include <plog/Log.h>
+
+#include <Shared/Command.hpp>
+#include <Shared/Network/Archive.h>
+
+using namespace network::protocol;
+
+namespace {
+	// Input without reaction for this long is considered lost
+	const sf::Time INPUT_TIMEOUT = sf::seconds(5);
+	const sf::Time CHAT_TIMEOUT = sf::seconds(10);
+
+	// Don't let one chatty connection starve other bots of the same thread
+	const uint MAX_PACKETS_PER_UPDATE = 64;
+
+	sf::Time randomDelay(std::mt19937 &random, sf::Time max) {
+		if (max == sf::Time::Zero)
+			return sf::Time::Zero;
+		std::uniform_int_distribution<sf::Int64> distribution(0, max.asMicroseconds());
+		return sf::microseconds(distribution(random));
+	}
+}
+
+Bot::Bot(const BotConfig &config, uint seed) :
+	config(config),
+	random(seed),
+	state(State::INACTIVE),
+	inputPending(false),
+	chatCounter(0),
+	controllable(-1)
+{ }
+
+bool Bot::Start() {
+	if (socket.connect(config.ip, config.port, sf::seconds(5)) != sf::Socket::Done) {
+		LOGE << config.login << ": connection failed";
+		state = State::FAILED;
+		return false;
+	}
+	socket.setBlocking(false);
+
+	// Account may already exist, authorization goes after any answer
+	RegistrationClientCommand command;
+	command.login = config.login;
+	command.password = config.password;
+	requestSent = clock.getElapsedTime();
+	state = State::REGISTRATION;
+	send(command);
+	return true;
+}
+
+bool Bot::Update() {
+	State current = state;
+	if (current == State::INACTIVE || current == State::FAILED)
+		return false;
+
+	std::unique_lock<std::mutex> lock(statsLock);
+	bool working = false;
+
+	for (uint i = 0; i < MAX_PACKETS_PER_UPDATE; i++) {
+		sf::Packet packet;
+		sf::Socket::Status status = socket.receive(packet);
+		if (status == sf::Socket::Disconnected || status == sf::Socket::Error) {
+			LOGE << config.login << ": disconnected by server";
+			state = State::FAILED;
+			return true;
+		}
+		if (status != sf::Socket::Done)
+			break;
+
+		stats.bytesReceived += packet.getDataSize() + sizeof(sf::Uint32); // with size header
+		parsePacket(packet, clock.getElapsedTime());
+		working = true;
+	}
+
+	if (state == State::PLAYING)
+		act(clock.getElapsedTime());
+
+	return working;
+}
+
+void Bot::Stop() {
+	if (state == State::INACTIVE || state == State::FAILED)
+		return;
+	socket.setBlocking(true);
+	send(DisconnectionClientCommand());
+	socket.disconnect();
+	state = State::INACTIVE;
+}
+
+Bot::State Bot::GetState() const { return state; }
+
+BotStats Bot::TakeStats() {
+	std::unique_lock<std::mutex> lock(statsLock);
+	BotStats result = std::move(stats);
+	stats = BotStats();
+	return result;
+}
+
+void Bot::send(const ClientCommand &command) {
+	sf::Packet packet;
+	uf::InputArchive ar(packet);
+	ar << command;
+	stats.bytesSent += packet.getDataSize() + sizeof(sf::Uint32);
+	while (socket.send(packet) == sf::Socket::Partial);
+}
+
+void Bot::act(sf::Time now) {
+	if (inputPending && now - inputSent > INPUT_TIMEOUT) {
+		stats.lostInputs++;
+		inputPending = false;
+	}
+	if (!chatPending.empty() && now - chatSent > CHAT_TIMEOUT)
+		chatPending.clear();
+
+	if (config.moveInterval != sf::Time::Zero && now >= nextMove) {
+		MoveClientCommand command;
+		command.direction = uf::Direction(std::uniform_int_distribution<int>(
+			int(uf::Direction::SOUTH), int(uf::Direction::EAST))(random));
+		send(command);
+		if (!inputPending) {
+			inputPending = true;
+			inputSent = now;
+		}
+		nextMove = now + config.moveInterval;
+	}
+
+	if (config.clickInterval != sf::Time::Zero && now >= nextClick && !visibleObjects.empty()) {
+		auto iter = visibleObjects.begin();
+		std::advance(iter, std::uniform_int_distribution<size_t>(0, visibleObjects.size() - 1)(random));
+		ClickObjectClientCommand command;
+		command.id = *iter;
+		send(command);
+		nextClick = now + config.clickInterval;
+	}
+
+	if (config.chatInterval != sf::Time::Zero && now >= nextChat && chatPending.empty()) {
+		SendChatMessageClientCommand command;
+		command.message = "load test " + config.login + " #" + std::to_string(chatCounter++);
+		chatPending = command.message;
+		chatSent = now;
+		send(command);
+		nextChat = now + config.chatInterval;
+	}
+}
+
+void Bot::parsePacket(sf::Packet &packet, sf::Time now) {
+	sf::Int32 code;
+	packet >> code;
+	switch (static_cast<ServerCommand::Code>(code)) {
+		case ServerCommand::Code::REG_SUCCESS:
+		case ServerCommand::Code::REG_ERROR: {
+			if (state != State::REGISTRATION)
+				break;
+			stats.registration.Add(now - requestSent);
+
+			AuthorizationClientCommand command;
+			command.login = config.login;
+			command.password = config.password;
+			requestSent = now;
+			state = State::AUTHORIZATION;
+			send(command);
+			break;
+		}
+		case ServerCommand::Code::AUTH_SUCCESS: {
+			if (state != State::AUTHORIZATION)
+				break;
+			stats.authorization.Add(now - requestSent);
+
+			JoinGameClientCommand command;
+			command.id = config.gameId;
+			requestSent = now;
+			state = State::JOINING;
+			send(command);
+			break;
+		}
+		case ServerCommand::Code::AUTH_ERROR:
+			LOGE << config.login << ": authorization failed";
+			state = State::FAILED;
+			break;
+		case ServerCommand::Code::GAME_JOIN_SUCCESS:
+		case ServerCommand::Code::GAME_JOIN_ERROR: {
+			// Server answers with error when the player reconnects to his old mob
+			if (state != State::JOINING)
+				break;
+			stats.joining.Add(now - requestSent);
+			state = State::PLAYING;
+
+			// Spread actions of bots started at the same moment
+			nextMove = now + randomDelay(random, config.moveInterval);
+			nextClick = now + randomDelay(random, config.clickInterval);
+			nextChat = now + randomDelay(random, config.chatInterval);
+			break;
+		}
+		case ServerCommand::Code::GRAPHICS_UPDATE:
+			if (!parseGraphicsUpdate(packet, now))
+				stats.decodeErrors++;
+			break;
+		case ServerCommand::Code::SEND_CHAT_MESSAGE: {
+			std::string message;
+			packet >> message;
+			// Message comes back as "<ckey>message"
+			if (!chatPending.empty() && message.size() >= chatPending.size() &&
+				!message.compare(message.size() - chatPending.size(), chatPending.size(), chatPending))
+			{
+				stats.chat.Add(now - chatSent);
+				chatPending.clear();
+			}
+			break;
+		}
+		default:
+			// Overlays and windows are not interesting for bots
+			break;
+	}
+}
+
+bool Bot::parseGraphicsUpdate(sf::Packet &packet, sf::Time now) {
+	stats.graphicsUpdates++;
+	if (lastGraphicsUpdate != sf::Time::Zero)
+		stats.updateInterval.Add(now - lastGraphicsUpdate);
+	lastGraphicsUpdate = now;
+
+	bool reacted = false;
+
+	sf::Int32 options;
+	packet >> options;
+	if (options & GraphicsUpdateServerCommand::Option::BLOCKS_SHIFT) {
+		sf::Int32 x, y, z, numOfBlocks;
+		packet >> x >> y >> z >> numOfBlocks;
+		visibleObjects.clear();
+		while (numOfBlocks-- > 0) {
+			packet >> x >> y >> z;
+			if (!parseTile(packet))
+				return false;
+		}
+	}
+	if (options & GraphicsUpdateServerCommand::Option::CAMERA_MOVE) {
+		sf::Int32 x, y, z;
+		packet >> x >> y >> z;
+	}
+	if (options & GraphicsUpdateServerCommand::Option::DIFFERENCES) {
+		sf::Int32 count;
+		packet >> count;
+		for (sf::Int32 i = 0; i < count; i++) {
+			sf::Int32 type, id;
+			packet >> type >> id;
+			switch (Global::DiffType(type)) {
+				case Global::DiffType::ADD: {
+					if (!parseObject(packet, id))
+						return false;
+					sf::Int32 toX, toY, toZ, toObjectNum;
+					packet >> toX >> toY >> toZ >> toObjectNum;
+					break;
+				}
+				case Global::DiffType::REMOVE:
+					visibleObjects.erase(id);
+					break;
+				case Global::DiffType::RELOCATE: {
+					sf::Int32 toX, toY, toZ, toObjectNum;
+					packet >> toX >> toY >> toZ >> toObjectNum;
+					reacted |= id == controllable;
+					break;
+				}
+				case Global::DiffType::MOVE_INTENT:
+				case Global::DiffType::CHANGE_DIRECTION: {
+					sf::Int8 direction;
+					packet >> direction;
+					reacted |= id == controllable;
+					break;
+				}
+				case Global::DiffType::MOVE: {
+					sf::Int8 direction;
+					float speed;
+					packet >> direction >> speed;
+					reacted |= id == controllable;
+					break;
+				}
+				case Global::DiffType::UPDATE_ICONS: {
+					sf::Int32 spriteNum, sprite;
+					packet >> spriteNum;
+					while (spriteNum-- > 0)
+						packet >> sprite;
+					break;
+				}
+				case Global::DiffType::PLAY_ANIMATION: {
+					sf::Int32 sprite;
+					packet >> sprite;
+					break;
+				}
+				case Global::DiffType::STUNNED: {
+					sf::Int32 duration;
+					packet >> duration;
+					break;
+				}
+				default:
+					LOGE << config.login << ": wrong diff type: " << type;
+					return false;
+			}
+		}
+	}
+	if (options & GraphicsUpdateServerCommand::Option::NEW_CONTROLLABLE) {
+		float speed;
+		packet >> controllable >> speed;
+	}
+
+	if (reacted && inputPending) {
+		stats.input.Add(now - inputSent);
+		inputPending = false;
+	}
+
+	return packet && packet.endOfPacket();
+}
+
+bool Bot::parseTile(sf::Packet &packet) {
+	sf::Int32 size, sprite;
+	packet >> size >> sprite;
+	while (size-- > 0) {
+		sf::Int32 id;
+		packet >> id;
+		if (!parseObject(packet, id))
+			return false;
+	}
+	return bool(packet);
+}
+
+bool Bot::parseObject(sf::Packet &packet, sf::Int32 id) {
+	sf::Int32 spriteNum, sprite, layer;
+	sf::Int8 direction;
+	sf::String name;
+	bool dense;
+	float moveSpeed, constSpeedX, constSpeedY;
+
+	packet >> spriteNum;
+	while (spriteNum-- > 0)
+		packet >> sprite;
+	packet >> name >> layer >> direction >> dense;
+	packet >> moveSpeed >> constSpeedX >> constSpeedY;
+
+	if (!packet)
+		return false;
+	visibleObjects.insert(id);
+	return true;
+}
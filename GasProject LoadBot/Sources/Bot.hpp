@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_set>
+
+#include <SFML/Network.hpp>
+
+#include <Shared/Types.hpp>
+#include <Shared/Global.hpp>
+#include <Shared/Network/Protocol/ClientCommand.h>
+
+#include "BotStats.hpp"
+
+struct BotConfig {
+	std::string ip = "127.0.0.1";
+	int port = Global::PORT;
+	std::string login;
+	std::string password;
+	int gameId = 0;
+
+	// Zero disables the action
+	sf::Time moveInterval = sf::milliseconds(500);
+	sf::Time clickInterval = sf::seconds(3);
+	sf::Time chatInterval = sf::seconds(10);
+};
+
+// Scripted client without graphics. Registers, authorizes, joins the game,
+// then walks randomly, clicks visible objects and writes to chat.
+// GRAPHICS_UPDATE stream is decoded completely, so the cost of the protocol is real.
+class Bot {
+public:
+	enum class State : char {
+		INACTIVE = 0,
+		REGISTRATION,
+		AUTHORIZATION,
+		JOINING,
+		PLAYING,
+		FAILED
+	};
+
+	Bot(const BotConfig &config, uint seed);
+
+	// Connect to the server (blocking) and start registration
+	bool Start();
+	// Process pending packets and scripted actions. Never blocks.
+	// Returns false if there was nothing to do.
+	bool Update();
+	void Stop();
+
+	State GetState() const;
+
+	// Stats gathered since the previous call. Thread safe.
+	BotStats TakeStats();
+
+private:
+	void send(const network::protocol::ClientCommand &command);
+	void act(sf::Time now);
+
+	void parsePacket(sf::Packet &packet, sf::Time now);
+	bool parseGraphicsUpdate(sf::Packet &packet, sf::Time now);
+	bool parseTile(sf::Packet &packet);
+	bool parseObject(sf::Packet &packet, sf::Int32 id);
+
+private:
+	BotConfig config;
+	std::mt19937 random;
+
+	sf::TcpSocket socket;
+	sf::Clock clock;
+	std::atomic<State> state;
+
+	sf::Time requestSent;       // registration, authorization, joining
+	sf::Time lastGraphicsUpdate;
+	sf::Time nextMove;
+	sf::Time nextClick;
+	sf::Time nextChat;
+
+	// Input waiting for the reaction of the server
+	bool inputPending;
+	sf::Time inputSent;
+
+	// Chat message waiting for broadcast
+	std::string chatPending;
+	sf::Time chatSent;
+	uint chatCounter;
+
+	sf::Int32 controllable;
+	std::unordered_set<sf::Int32> visibleObjects;
+
+	mutable std::mutex statsLock;
+	BotStats stats;
+};
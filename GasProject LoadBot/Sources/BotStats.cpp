@@ -0,0 +1,65 @@
+#include "BotStats.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+void LatencyStats::Add(sf::Time time) {
+	samples.push_back(time.asMicroseconds());
+}
+
+void LatencyStats::Merge(const LatencyStats &other) {
+	samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+}
+
+size_t LatencyStats::Count() const { return samples.size(); }
+
+sf::Time LatencyStats::Mean() const {
+	if (samples.empty())
+		return sf::Time::Zero;
+	sf::Int64 sum = 0;
+	for (auto sample : samples)
+		sum += sample;
+	return sf::microseconds(sum / sf::Int64(samples.size()));
+}
+
+sf::Time LatencyStats::Percentile(float percent) const {
+	if (samples.empty())
+		return sf::Time::Zero;
+	std::vector<sf::Int64> sorted = samples;
+	size_t index = std::min(sorted.size() - 1, size_t(sorted.size() * percent / 100));
+	std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+	return sf::microseconds(sorted[index]);
+}
+
+sf::Time LatencyStats::Max() const {
+	if (samples.empty())
+		return sf::Time::Zero;
+	return sf::microseconds(*std::max_element(samples.begin(), samples.end()));
+}
+
+std::string LatencyStats::ToString() const {
+	if (samples.empty())
+		return "no samples";
+	std::ostringstream ss;
+	ss.precision(3);
+	ss << "mean " << Mean().asMicroseconds() / 1000.f << "ms"
+	   << ", p99 " << Percentile(99).asMicroseconds() / 1000.f << "ms"
+	   << ", max " << Max().asMicroseconds() / 1000.f << "ms"
+	   << " (" << samples.size() << ")";
+	return ss.str();
+}
+
+void BotStats::Merge(const BotStats &other) {
+	registration.Merge(other.registration);
+	authorization.Merge(other.authorization);
+	joining.Merge(other.joining);
+	chat.Merge(other.chat);
+	input.Merge(other.input);
+	updateInterval.Merge(other.updateInterval);
+
+	bytesSent += other.bytesSent;
+	bytesReceived += other.bytesReceived;
+	graphicsUpdates += other.graphicsUpdates;
+	lostInputs += other.lostInputs;
+	decodeErrors += other.decodeErrors;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <SFML/System/Time.hpp>
+
+#include <Shared/Types.hpp>
+
+class LatencyStats {
+public:
+	void Add(sf::Time time);
+	void Merge(const LatencyStats &other);
+
+	size_t Count() const;
+	sf::Time Mean() const;
+	sf::Time Percentile(float percent) const;
+	sf::Time Max() const;
+
+	// "mean 1.2ms, p99 3.4ms, max 5.6ms (N)"
+	std::string ToString() const;
+
+private:
+	std::vector<sf::Int64> samples; // microseconds
+};
+
+struct BotStats {
+	// Server responsiveness
+	LatencyStats registration;
+	LatencyStats authorization;
+	LatencyStats joining;
+	LatencyStats chat;           // own chat message is broadcasted back
+
+	// Time from MoveClientCommand till the first diff of controllable reacting on it.
+	// Includes network, waiting for the tick and the tick itself.
+	LatencyStats input;
+	LatencyStats updateInterval; // between GRAPHICS_UPDATEs
+
+	uint64_t bytesSent = 0;
+	uint64_t bytesReceived = 0;
+	uint64_t graphicsUpdates = 0;
+	uint64_t lostInputs = 0;     // no reaction for a long time
+	uint64_t decodeErrors = 0;
+
+	void Merge(const BotStats &other);
+};
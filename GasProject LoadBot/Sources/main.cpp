@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <plog/Log.h>
+#include <plog/Appenders/ConsoleAppender.h>
+#include <plog/Formatters/MessageOnlyFormatter.h>
+
+#include <SFML/System.hpp>
+
+#include "Bot.hpp"
+#include "BotStats.hpp"
+
+namespace {
+
+struct Options {
+	BotConfig bot;
+	uint bots = 100;
+	uint threads = 0;              // 0 - by hardware
+	uint games = 1;                // bots are spread over games 0..games-1
+	float rampPerSecond = 50;      // new connections per second
+	sf::Time duration = sf::seconds(60);
+	sf::Time reportInterval = sf::seconds(5);
+	std::string loginPrefix = "bot";
+};
+
+void printUsage() {
+	std::cout <<
+		"Usage: GasProject_LoadBot [options]\n"
+		"  --host <ip>              server address (127.0.0.1)\n"
+		"  --port <port>            server port (" << Global::PORT << ")\n"
+		"  --bots <n>               number of clients (100)\n"
+		"  --threads <n>            worker threads, 0 - by hardware (0)\n"
+		"  --games <n>              spread bots over the first n games (1)\n"
+		"  --ramp <n>               connections per second (50)\n"
+		"  --duration <s>           test duration in seconds (60)\n"
+		"  --report <s>             report interval in seconds (5)\n"
+		"  --login <prefix>         bots' logins are <prefix><index> (bot)\n"
+		"  --password <password>    password of all bots (bot)\n"
+		"  --move <ms>              interval between moves, 0 - don't move (500)\n"
+		"  --click <ms>             interval between clicks, 0 - don't click (3000)\n"
+		"  --chat <ms>              interval between chat messages, 0 - silent (10000)\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+	options.bot.password = "bot";
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--help")
+			return false;
+		if (i + 1 >= argc) {
+			std::cout << "No value for " << arg << std::endl;
+			return false;
+		}
+		std::string value = argv[++i];
+		try {
+			if (arg == "--host") options.bot.ip = value;
+			else if (arg == "--port") options.bot.port = std::stoi(value);
+			else if (arg == "--bots") options.bots = uint(std::stoul(value));
+			else if (arg == "--threads") options.threads = uint(std::stoul(value));
+			else if (arg == "--games") options.games = uint(std::stoul(value));
+			else if (arg == "--ramp") options.rampPerSecond = std::stof(value);
+			else if (arg == "--duration") options.duration = sf::seconds(std::stof(value));
+			else if (arg == "--report") options.reportInterval = sf::seconds(std::stof(value));
+			else if (arg == "--login") options.loginPrefix = value;
+			else if (arg == "--password") options.bot.password = value;
+			else if (arg == "--move") options.bot.moveInterval = sf::milliseconds(std::stoi(value));
+			else if (arg == "--click") options.bot.clickInterval = sf::milliseconds(std::stoi(value));
+			else if (arg == "--chat") options.bot.chatInterval = sf::milliseconds(std::stoi(value));
+			else {
+				std::cout << "Unknown option " << arg << std::endl;
+				return false;
+			}
+		} catch (const std::exception &) {
+			std::cout << "Wrong value for " << arg << ": " << value << std::endl;
+			return false;
+		}
+	}
+	return options.rampPerSecond > 0 && options.reportInterval > sf::Time::Zero && options.games > 0;
+}
+
+std::string report(const BotStats &stats, sf::Time period, size_t clients) {
+	std::ostringstream ss;
+	ss.precision(3);
+	float seconds = std::max(period.asSeconds(), 0.001f);
+	float perClient = 1.f / std::max<size_t>(clients, 1) / seconds / 1024;
+
+	ss << "  input latency:    " << stats.input.ToString() << ", lost " << stats.lostInputs << "\n"
+	   << "  update interval:  " << stats.updateInterval.ToString() << "\n"
+	   << "  chat round trip:  " << stats.chat.ToString() << "\n"
+	   << "  registration:     " << stats.registration.ToString() << "\n"
+	   << "  authorization:    " << stats.authorization.ToString() << "\n"
+	   << "  joining:          " << stats.joining.ToString() << "\n"
+	   << "  traffic per client: rx " << stats.bytesReceived * perClient << " KB/s"
+	   << ", tx " << stats.bytesSent * perClient << " KB/s"
+	   << ", updates " << stats.graphicsUpdates / std::max<size_t>(clients, 1) / seconds << "/s"
+	   << ", decode errors " << stats.decodeErrors;
+	return ss.str();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	plog::ConsoleAppender<plog::MessageOnlyFormatter> appender;
+	plog::init(plog::info, &appender);
+
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage();
+		return 1;
+	}
+
+	std::vector<uptr<Bot>> bots;
+	bots.reserve(options.bots);
+	for (uint i = 0; i < options.bots; i++) {
+		BotConfig config = options.bot;
+		config.login = options.loginPrefix + std::to_string(i);
+		config.gameId = int(i % options.games);
+		bots.push_back(std::make_unique<Bot>(config, i));
+	}
+
+	uint threadsCount = options.threads ? options.threads : std::max(std::thread::hardware_concurrency(), 1u);
+	threadsCount = std::max(std::min(threadsCount, options.bots), 1u);
+
+	LOGI << "Starting " << options.bots << " bots on " << threadsCount << " threads against "
+	     << options.bot.ip << ":" << options.bot.port;
+
+	sf::Clock clock;
+	std::atomic<bool> active(true);
+	std::vector<std::thread> threads;
+	for (uint t = 0; t < threadsCount; t++) {
+		threads.emplace_back([&, t]() {
+			std::vector<Bot *> own;
+			std::vector<sf::Time> startAt;
+			for (uint i = t; i < bots.size(); i += threadsCount) {
+				own.push_back(bots[i].get());
+				startAt.push_back(sf::seconds(i / options.rampPerSecond));
+			}
+			std::vector<bool> started(own.size(), false);
+
+			while (active) {
+				bool working = false;
+				for (size_t i = 0; i < own.size(); i++) {
+					if (!started[i]) {
+						if (clock.getElapsedTime() < startAt[i])
+							continue;
+						started[i] = true;
+						own[i]->Start();
+					}
+					working |= own[i]->Update();
+				}
+				if (!working)
+					sf::sleep(sf::milliseconds(1));
+			}
+
+			for (auto *bot : own)
+				bot->Stop();
+		});
+	}
+
+	BotStats total;
+	sf::Time lastReport = clock.getElapsedTime();
+	while (clock.getElapsedTime() < options.duration) {
+		sf::sleep(std::min(options.reportInterval, options.duration - clock.getElapsedTime()));
+
+		BotStats interval;
+		size_t playing = 0, failed = 0;
+		for (auto &bot : bots) {
+			interval.Merge(bot->TakeStats());
+			playing += bot->GetState() == Bot::State::PLAYING;
+			failed += bot->GetState() == Bot::State::FAILED;
+		}
+		total.Merge(interval);
+
+		sf::Time now = clock.getElapsedTime();
+		LOGI << "[" << int(now.asSeconds()) << "s] playing " << playing << "/" << bots.size()
+		     << ", failed " << failed << "\n" << report(interval, now - lastReport, std::max<size_t>(playing, 1));
+		lastReport = now;
+	}
+
+	active = false;
+	for (auto &thread : threads)
+		thread.join();
+
+	LOGI << "Total for " << options.bots << " bots:\n" << report(total, clock.getElapsedTime(), options.bots);
+	return 0;
+}
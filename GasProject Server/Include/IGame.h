@@ -1,15 +1,28 @@
 #pragma once
 
+#include <string>
+
 #include <Shared/IFaces/INonCopyable.h>
 #include <Shared/Types.hpp>
 
+#include <VerbsHolder.h>
+
 class Player;
 class Control;
 class World;
 class Chat;
+class InputRecorder;
+struct TickStats;
 
-class IGame : public INonCopyable {
+class IGame : public INonCopyable, public VerbsHolder {
 public:
+	virtual uint GetID() const = 0;
+	virtual std::string GetTitle() const = 0;
+	// Thread safe
+	virtual uint GetPlayersCount() const = 0;
+	// True if the player with the ckey is in the game, connected or not. Thread safe.
+	virtual bool HasPlayer(const std::string &ckey) const = 0;
+
 	// True if new player created, false if exist player reconnected
 	virtual bool AddPlayer(sptr<Player> &) = 0;
 	virtual void SendChatMessages() = 0;
@@ -17,6 +30,8 @@ public:
 	virtual Control *GetStartControl(Player *) = 0;
 	virtual const uptr<World> &GetWorld() const = 0;
 	virtual Chat *GetChat() = 0;
+	virtual TickStats GetTickStats() const = 0;
+	// Null if players' commands aren't recorded
+	virtual InputRecorder *GetInputRecorder() = 0;
 };
 
-extern IGame *GGame;
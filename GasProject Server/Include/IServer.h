@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include <Shared/IFaces/INonCopyable.h>
 #include <Shared/Types.hpp>
 
@@ -11,9 +14,13 @@ class IServer : public INonCopyable {
 public:
 	virtual Player *Authorization(const std::string &login, const std::string &password) const = 0;
 	virtual bool Registration(const std::string &login, const std::string &password) const = 0;
-	virtual bool JoinGame(sptr<Player> &player) const = 0;
+	// True if new player created, false if exist player reconnected or there is no such game.
+	// Player who left a game is returned to it whatever the id is.
+	virtual bool JoinGame(sptr<Player> &player, uint gameId) const = 0;
 
-	virtual IGame *GetGame() const = 0;
+	// Null if there is no game with the id
+	virtual IGame *GetGame(uint id) const = 0;
+	virtual std::vector<IGame *> GetGames() const = 0;
 	//virtual UsersDB *GetUDB() const;
 	virtual ResourceManager *GetRM() const = 0;
 };
@@ -1,42 +1,166 @@
 #include <Game.h>
 
-#include <SFML/System/Clock.hpp>
-#include <SFML/System/Sleep.hpp>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+#include <plog/Log.h>
 
 #include <Shared/Command.hpp>
+#include <Shared/Trace.hpp>
+
+#include <Global.hpp>
 
 #include <Network/Connection.hpp>
 #include <World/World.hpp>
+#include <World/WorldSnapshot.hpp>
+#include <World/MapFile.hpp>
 #include <World/Objects/Control.hpp>
 #include <World/Objects/Creature.hpp>
 #include <World/Map.hpp>
 
-Game::Game() :
-	active(true)
+void TickStatsVerb(Player *player) {
+	IGame *game = player->GetGame();
+	const uptr<World> &world = game->GetWorld();
+	std::string message = game->GetTitle() + " tick stats: " + game->GetTickStats().ToString() +
+		", active objects " + std::to_string(world->GetActiveObjectsCount()) + "/" + std::to_string(world->GetObjectsCount()) +
+		", reclaimed objects " + std::to_string(world->GetReclaimedObjectsCount()) +
+		", allocated map chunks " + std::to_string(world->GetMap()->GetAllocatedChunksCount()) +
+		", active locales " + std::to_string(world->GetMap()->GetAtmos()->GetActiveLocalesCount()) +
+		", sleeping locales " + std::to_string(world->GetMap()->GetAtmos()->GetSleepingLocalesCount()) +
+		", heated chunks " + std::to_string(world->GetMap()->GetHeat()->GetActiveChunksCount());
+	player->AddCommandToClient(new SendChatMessageServerCommand(message));
+}
+
+void TraceVerb(Player *player) {
+	std::string message;
+	if (!uf::trace::IsEnabled()) {
+		uf::trace::SetEnabled(true);
+		LOGI << "Tracing is enabled by " << player->GetCKey();
+		message = "Tracing is enabled. Use game.tracedump to save the trace";
+	} else {
+		uf::trace::SetEnabled(false);
+		LOGI << "Tracing is disabled by " << player->GetCKey();
+		message = "Tracing is disabled";
+	}
+	player->AddCommandToClient(new SendChatMessageServerCommand(message));
+}
+
+void TraceDumpVerb(Player *player) {
+	std::string path = "trace-" + std::to_string(std::time(nullptr)) + ".json";
+	std::string message;
+	if (uf::trace::DumpChromeTrace(path)) {
+		LOGI << "Trace is dumped to " << path;
+		message = "Trace is dumped to " + path + " on the server";
+	} else {
+		LOGE << "Failed to dump trace to " << path;
+		message = "Failed to dump trace";
+	}
+	player->AddCommandToClient(new SendChatMessageServerCommand(message));
+}
+
+void SaveVerb(Player *player) {
+	IGame *game = player->GetGame();
+	LOGI << "Snapshot of " << game->GetTitle() << " is requested by " << player->GetCKey();
+	// Verbs are called from the network thread, the game thread takes the snapshot at the end of its tick
+	static_cast<Game *>(game)->RequestSnapshot();
+	std::string message = "World snapshot will be saved on the server";
+	player->AddCommandToClient(new SendChatMessageServerCommand(message));
+}
+
+void SaveMapVerb(Player *player) {
+	IGame *game = player->GetGame();
+	LOGI << "Map of " << game->GetTitle() << " is requested to be saved by " << player->GetCKey();
+	// Verbs are called from the network thread, the game thread writes the map at the end of its tick
+	static_cast<Game *>(game)->RequestMapSave();
+	std::string message = "Map will be saved to " + Global::MapPath + " on the server";
+	player->AddCommandToClient(new SendChatMessageServerCommand(message));
+}
+
+namespace {
+
+// Every game builds views at the end of its tick, so by default they share hardware threads
+uint viewBuildingThreads() {
+	if (Global::ViewBuildingThreads)
+		return Global::ViewBuildingThreads;
+	uint hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	uint perGame = std::max(hardwareThreads / std::max(Global::GamesCount, 1u), 1u);
+	// Calling thread takes part in the work
+	return std::max(perGame - 1, 1u);
+}
+
+}
+
+Game::Game(uint id, GameMode mode) :
+	id(id),
+	title("Game " + std::to_string(id + 1)),
+	mode(mode),
+	active(true),
+	scheduler(Global::TicksPerSecond, TickOverrunPolicy::CatchUp, Global::MaxCatchUpTicks),
+	viewBuilders(viewBuildingThreads()),
+	lastReportedOverruns(0),
+	snapshotRequested(false),
+	mapSaveRequested(false),
+	tick(0)
 {
-	thread = std::make_unique<std::thread>(&Game::gameProcess, this);
+	AddVerb("tickstats", &TickStatsVerb);
+	AddVerb("trace", &TraceVerb);
+	AddVerb("tracedump", &TraceDumpVerb);
+	AddVerb("save", &SaveVerb);
+	AddVerb("savemap", &SaveMapVerb);
+	if (mode != GameMode::Replay)
+		thread = std::make_unique<std::thread>(&Game::gameProcess, this);
 }
 
 void Game::gameProcess() {
-	world.reset(new World());
-	world->FillingWorld();
-	sf::Clock clock;
-	while (active) {
-		update(clock.restart());
-		sf::Time timeToSleep = sf::seconds(0.05f) - clock.getElapsedTime(); // 10 ticks per second
-		if (timeToSleep > sf::Time::Zero)
-			sf::sleep(timeToSleep);
+	uf::trace::SetThreadName(title);
+	bool restored = loadSnapshot();
+	if (!restored) {
+		world.reset(new World());
+		world->LoadMap(Global::MapPath);
+		world->FillingWorld();
 	}
+	if (mode == GameMode::Recording) {
+		std::string path = Global::InputRecordingPrefix + std::to_string(id) + ".bin";
+		if (restored) {
+			LOGW << title << " is restored from a snapshot, its input isn't recorded: replays start from a fresh world";
+		} else {
+			recorder = std::make_unique<InputRecorder>(path, Global::TicksPerSecond);
+			if (recorder->IsOpen()) {
+				LOGI << title << " records players' input to " << path;
+			} else {
+				LOGE << title << " failed to open " << path << " for recording";
+				recorder.reset();
+			}
+		}
+	}
+	scheduler.Run(active, [this](sf::Time timestep) {
+		waitSnapshotTaken();
+		update(timestep);
+		reportTickStats();
+		updateMapSave();
+		updateSnapshots();
+	});
+	if (snapshotWriting.valid())
+		snapshotWriting.wait();
 }
 
 void Game::update(sf::Time timeElapsed) {
+	TRACE_SCOPE("Game::Tick");
+	if (recorder)
+		recorder->SetTick(tick);
+
 	world->Update(timeElapsed);
 	{
+		TRACE_SCOPE("Game::Players");
 		std::unique_lock<std::mutex> lock(playersLock);
+		std::vector<Player *> viewers;
+		viewers.reserve(players.size());
 		for (auto iter = players.begin(); iter != players.end();) {
 			sptr<Player> player = *iter;
 			if (player->IsConnected()) {
 				player->Update(timeElapsed);
+				viewers.push_back(player.get());
 				iter++;
 			} else {
 				// If player disconnected, move him into disconnectedPlayers list
@@ -53,11 +177,119 @@ void Game::update(sf::Time timeElapsed) {
 			}
 		}
 
-		for (wptr<Player> player : players)
-			if (sptr<Player> player_s = player.lock())
-				player_s->SendGraphicsUpdates(timeElapsed);
+		// World is not changed until the end of the stage, so map and tiles' diffs are read-only here
+		// and every camera can build its view independently
+		TRACE_SCOPE("Game::BuildViews");
+		viewBuilders.ParallelFor(viewers.size(), [&viewers, timeElapsed](size_t i) {
+			viewers[i]->SendGraphicsUpdates(timeElapsed);
+		});
 	}
+	// Cameras are done, nobody refers to deleted objects anymore
+	world->ReclaimDeletedObjects();
 	SendChatMessages();
+	tick++;
+}
+
+void Game::reportTickStats() {
+	timeSinceTickReport += scheduler.GetTimestep();
+	if (timeSinceTickReport < sf::seconds(10))
+		return;
+	timeSinceTickReport = sf::Time::Zero;
+
+	TickStats stats = scheduler.GetStats();
+	if (stats.overruns != lastReportedOverruns) {
+		LOGW << title << " is over the tick budget: " << stats.ToString();
+		lastReportedOverruns = stats.overruns;
+	}
+}
+
+std::string Game::snapshotPath() const {
+	return Global::SnapshotPrefix + std::to_string(id) + ".bin";
+}
+
+bool Game::loadSnapshot() {
+	sf::Packet packet;
+	std::string path = snapshotPath();
+	if (!WorldSnapshot::ReadFile(path, packet))
+		return false;
+
+	// Snapshot keeps only materialized regions of the map file, the rest is still read from it
+	world.reset(new World());
+	world->LoadMap(Global::MapPath);
+	if (!WorldSnapshot::Load(world.get(), packet)) {
+		LOGE << title << " failed to restore the world from " << path;
+		world.reset();
+		return false;
+	}
+	LOGI << title << " restored the world from " << path << " (" << world->GetObjectsCount() << " objects)";
+	return true;
+}
+
+void Game::saveSnapshot() {
+	TRACE_SCOPE("Game::SaveSnapshot");
+
+	// Previous snapshot is still being taken or written, next tick will try again
+	if (snapshotWriting.valid() && snapshotWriting.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		snapshotRequested = true;
+		return;
+	}
+	timeSinceSnapshot = sf::Time::Zero;
+
+	// World is serialized while the game thread waits for the next tick, so nobody changes it.
+	// Next tick waits only if serialization takes longer than the rest of the tick.
+	auto taken = std::make_shared<std::promise<void>>();
+	snapshotTaken = taken->get_future();
+	snapshotWriting = std::async(std::launch::async, [this, taken, path = snapshotPath()]() {
+		sf::Clock clock;
+		sf::Packet packet;
+		bool saved = true;
+		try {
+			WorldSnapshot::Save(world.get(), packet);
+		} catch (const std::exception &) {
+			saved = false;
+		}
+		taken->set_value();
+
+		if (!saved) {
+			LOGE << title << " failed to take a snapshot";
+			return false;
+		}
+		LOGI << title << " snapshot is taken in " << clock.getElapsedTime().asMilliseconds() << " ms, "
+			<< packet.getDataSize() << " bytes";
+		return WorldSnapshot::WriteFile(path, packet);
+	});
+}
+
+void Game::waitSnapshotTaken() {
+	if (!snapshotTaken.valid())
+		return;
+	TRACE_SCOPE("Game::WaitSnapshot");
+	sf::Clock clock;
+	snapshotTaken.get();
+	sf::Time waited = clock.getElapsedTime();
+	if (waited >= sf::milliseconds(1))
+		LOGW << title << " tick waited " << waited.asMilliseconds() << " ms for the snapshot";
+}
+
+void Game::updateMapSave() {
+	if (!mapSaveRequested.exchange(false))
+		return;
+	TRACE_SCOPE("Game::SaveMap");
+	if (MapFile::Write(Global::MapPath, world->GetMap()))
+		LOGI << title << " saved the map to " << Global::MapPath;
+	else
+		LOGE << title << " failed to save the map to " << Global::MapPath;
+}
+
+void Game::updateSnapshots() {
+	bool requested = snapshotRequested.exchange(false);
+	if (Global::SnapshotInterval) {
+		timeSinceSnapshot += scheduler.GetTimestep();
+		if (timeSinceSnapshot >= sf::seconds(float(Global::SnapshotInterval)))
+			requested = true;
+	}
+	if (requested)
+		saveSnapshot();
 }
 
 bool Game::AddPlayer(sptr<Player> &player) {
@@ -74,16 +306,31 @@ bool Game::AddPlayer(sptr<Player> &player) {
 		}
 	}
 	players.push_back(player);
-	player->JoinToGame();
+	player->JoinToGame(this);
 
 	return true;
 }
 
+uint Game::GetPlayersCount() const {
+	std::unique_lock<std::mutex> lock(playersLock);
+	return uint(players.size());
+}
+
+bool Game::HasPlayer(const std::string &ckey) const {
+	std::unique_lock<std::mutex> lock(playersLock);
+	for (auto &list : { &players, &disconnectedPlayers })
+		for (auto &player : *list)
+			if (player->GetCKey() == ckey)
+				return true;
+	return false;
+}
+
 Control *Game::GetStartControl(Player *player) {
 	return world->CreateNewPlayerCreature()->GetComponent<Control>();
 }
 
 void Game::SendChatMessages() {
+	TRACE_SCOPE("Game::SendChatMessages");
 	std::vector<std::string> messages = chat.GetNewMessages();
 	for (auto &player : players)
 		for (auto &message : messages)
@@ -92,7 +339,7 @@ void Game::SendChatMessages() {
 
 Game::~Game() {
 	active = false;
-	thread->join();
+	if (thread)
+		thread->join();
 }
 
-IGame *GGame = nullptr;
@@ -1,21 +1,40 @@
 #pragma once
 
+#include <atomic>
+#include <future>
 #include <list>
+#include <string>
 #include <thread>
 
 #include <SFML/Network/Packet.hpp>
 
 #include <Shared/Types.hpp>
+#include <Shared/ThreadPool.hpp>
 
 #include <IGame.h>
 #include <Player.hpp>
 #include <Chat.h>
+#include <TickScheduler.hpp>
+#include <InputRecording.hpp>
 
 class World;
 
+enum class GameMode : char {
+	Normal,
+	Recording, // players' commands are recorded for replays
+	Replay     // no tick thread, InputReplay updates the game
+};
+
 class Game : public IGame {
 public:
-	Game();
+	friend InputReplay;
+
+	explicit Game(uint id, GameMode mode = GameMode::Normal);
+
+	uint GetID() const override { return id; }
+	std::string GetTitle() const override { return title; }
+	uint GetPlayersCount() const override;
+	bool HasPlayer(const std::string &ckey) const override;
 
 	// True if new player created, false if exist player reconnected
 	bool AddPlayer(sptr<Player> &);
@@ -25,22 +44,65 @@ public:
 	const uptr<World> &GetWorld() const { return world; }
 
 	Chat *GetChat() { return &chat; }
+	TickStats GetTickStats() const override { return scheduler.GetStats(); }
+	InputRecorder *GetInputRecorder() override { return recorder.get(); }
 
 	void SendChatMessages();
+	// Snapshot is taken at the end of the current tick. Thread safe.
+	void RequestSnapshot() { snapshotRequested = true; }
+	// Map file is written at the end of the current tick. Thread safe.
+	void RequestMapSave() { mapSaveRequested = true; }
 	~Game();
 
 private:
-	bool active;
+	uint id;
+	std::string title;
+	GameMode mode;
+
+	std::atomic<bool> active;
+	TickScheduler scheduler;
 	uptr<std::thread> thread;
 	uptr<World> world;
 
 	std::list<sptr<Player>> players;
 	std::list<sptr<Player>> disconnectedPlayers;
-	std::mutex playersLock;
+	mutable std::mutex playersLock;
+
+	// Builds players' views in parallel after the world update
+	uf::ThreadPool viewBuilders;
 
 	Chat chat;
 
 	void gameProcess();
 
 	void update(sf::Time timeElapsed);
+	void reportTickStats();
+
+	std::string snapshotPath() const;
+	// Restore world from the last snapshot, false if there is no valid one
+	bool loadSnapshot();
+	// World is serialized in the background between ticks, then the file is written
+	void saveSnapshot();
+	void updateSnapshots();
+	// Call before the world is changed
+	void waitSnapshotTaken();
+	// Write the map file if it's requested
+	void updateMapSave();
+
+	sf::Time timeSinceTickReport;
+	uint64_t lastReportedOverruns;
+
+	// Set by verbs from the network thread, consumed by the game thread
+	std::atomic<bool> snapshotRequested;
+	sf::Time timeSinceSnapshot;
+	// Ready when the world isn't read anymore
+	std::future<void> snapshotTaken;
+	std::future<bool> snapshotWriting;
+
+	// Set by verbs from the network thread, consumed by the game thread
+	std::atomic<bool> mapSaveRequested;
+
+	// Ticks since the start, for the game thread only
+	uint64_t tick;
+	uptr<InputRecorder> recorder;
 };
@@ -1,5 +1,28 @@
+#pragma once
+
 #include <string>
 
 namespace Global {
     const std::string DatabaseName = "UsersDB";
-}
\ No newline at end of file
+
+    const unsigned TicksPerSecond = 20;
+    // How many missed ticks the game may run back-to-back after an overrun
+    const unsigned MaxCatchUpTicks = 5;
+    // Independent games hosted by the server, each with its own world and tick thread
+    const unsigned GamesCount = 2;
+    // Worker threads for building players' views of every game.
+    // 0 means hardware threads are shared between games.
+    const unsigned ViewBuildingThreads = 0;
+
+    // Every game saves its world to "<prefix><game id>.bin" and restores it on the start
+    const std::string SnapshotPrefix = "WorldSnapshot_";
+    // Seconds between automatic snapshots. 0 disables them, game.save still works.
+    const unsigned SnapshotInterval = 60;
+
+    // Turfs and static objects of every game. Without the file the hard-coded station is built,
+    // game.savemap writes the current one.
+    const std::string MapPath = "Resources/Maps/Station.map";
+
+    // With --record every game writes players' commands to "<prefix><game id>.bin"
+    const std::string InputRecordingPrefix = "InputRecording_";
+}
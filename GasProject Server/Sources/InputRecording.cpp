@@ -0,0 +1,231 @@
+#include "InputRecording.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <plog/Log.h>
+
+#include <SFML/Network/Packet.hpp>
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <Shared/CRC32.h>
+#include <Shared/Command.hpp>
+#include <Shared/Trace.hpp>
+
+#include <Global.hpp>
+#include <Game.h>
+#include <Player.hpp>
+#include <Network/Connection.hpp>
+#include <World/World.hpp>
+#include <World/Map.hpp>
+
+namespace {
+
+const sf::Uint32 RECORDING_MAGIC = "OSS-13 Input Recording"_crc32;
+// Increase on any change of the format
+const sf::Uint32 RECORDING_VERSION = 1;
+
+void writeFrame(std::ofstream &file, const sf::Packet &packet) {
+	sf::Uint32 size = sf::Uint32(packet.getDataSize());
+	file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+	file.write(static_cast<const char *>(packet.getData()), size);
+}
+
+bool readFrame(std::ifstream &file, sf::Packet &packet) {
+	sf::Uint32 size;
+	if (!file.read(reinterpret_cast<char *>(&size), sizeof(size)))
+		return false;
+	std::vector<char> data(size);
+	if (!file.read(data.data(), size))
+		return false;
+	packet.clear();
+	packet.append(data.data(), size);
+	return true;
+}
+
+void writeCommand(sf::Packet &packet, const PlayerCommand &command) {
+	packet << sf::Int8(command.GetCode());
+	switch (command.GetCode()) {
+		case PlayerCommand::Code::MOVE: {
+			auto &move = static_cast<const MovePlayerCommand &>(command);
+			packet << sf::Int32(move.order.x) << sf::Int32(move.order.y);
+			break;
+		}
+		case PlayerCommand::Code::MOVEZ:
+			packet << static_cast<const MoveZPlayerCommand &>(command).order;
+			break;
+		case PlayerCommand::Code::CLICK_OBJECT:
+			packet << sf::Uint32(static_cast<const ClickObjectPlayerCommand &>(command).id);
+			break;
+		default:
+			break;
+	}
+}
+
+uptr<PlayerCommand> readCommand(sf::Packet &packet) {
+	sf::Int8 code;
+	packet >> code;
+	switch (PlayerCommand::Code(code)) {
+		case PlayerCommand::Code::JOIN:
+			return std::make_unique<JoinPlayerCommand>();
+		case PlayerCommand::Code::MOVE: {
+			sf::Int32 x, y;
+			packet >> x >> y;
+			return std::make_unique<MovePlayerCommand>(uf::vec2i(x, y));
+		}
+		case PlayerCommand::Code::MOVEZ: {
+			bool up;
+			packet >> up;
+			return std::make_unique<MoveZPlayerCommand>(up);
+		}
+		case PlayerCommand::Code::CLICK_OBJECT: {
+			sf::Uint32 id;
+			packet >> id;
+			return std::make_unique<ClickObjectPlayerCommand>(id);
+		}
+		case PlayerCommand::Code::DROP:
+			return std::make_unique<DropPlayerCommand>();
+		case PlayerCommand::Code::BUILD:
+			return std::make_unique<BuildPlayerCommand>();
+		case PlayerCommand::Code::GHOST:
+			return std::make_unique<GhostPlayerCommand>();
+		default:
+			return nullptr;
+	}
+}
+
+}
+
+InputRecorder::InputRecorder(const std::string &path, uint ticksPerSecond) :
+	file(path, std::ios::binary | std::ios::trunc),
+	tick(0)
+{
+	sf::Packet header;
+	header << RECORDING_MAGIC << RECORDING_VERSION << sf::Uint32(ticksPerSecond);
+	writeFrame(file, header);
+}
+
+InputRecorder::~InputRecorder() {
+	// Recorder is destroyed after the last tick is finished
+	sf::Packet end;
+	end << sf::Uint64(tick + 1) << std::string();
+	writeFrame(file, end);
+}
+
+void InputRecorder::Record(const std::string &ckey, const PlayerCommand &command) {
+	sf::Packet packet;
+	packet << sf::Uint64(tick) << ckey;
+	writeCommand(packet, command);
+	writeFrame(file, packet);
+}
+
+bool InputReader::Open(const std::string &path) {
+	file.open(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	sf::Packet header;
+	sf::Uint32 magic, version, ticks;
+	if (!readFrame(file, header) || !(header >> magic >> version >> ticks) || magic != RECORDING_MAGIC) {
+		LOGE << path << " is not an input recording";
+		return false;
+	}
+	if (version != RECORDING_VERSION || !ticks) {
+		LOGE << "Input recording " << path << " has unsupported version " << version;
+		return false;
+	}
+	ticksPerSecond = ticks;
+	return true;
+}
+
+bool InputReader::Next(RecordedInput &input) {
+	sf::Packet packet;
+	sf::Uint64 tick;
+	if (!readFrame(file, packet) || !(packet >> tick >> input.ckey))
+		return false;
+	input.tick = tick;
+	if (input.ckey.empty()) {
+		input.command.reset();
+		return true;
+	}
+	input.command = readCommand(packet);
+	return input.command && packet;
+}
+
+bool InputReplay::Run(const std::string &path) {
+	InputReader reader;
+	if (!reader.Open(path))
+		return false;
+
+	Game game(0, GameMode::Replay);
+	game.world.reset(new World());
+	game.world->LoadMap(Global::MapPath);
+	game.world->FillingWorld();
+
+	std::map<std::string, sptr<Player>> players;
+	std::vector<sptr<Connection>> connections;
+	const sf::Time timestep = sf::seconds(1.f / reader.GetTicksPerSecond());
+
+	RecordedInput input;
+	bool ended = false;
+	bool broken = !reader.Next(input);
+	sf::Time total;
+	sf::Time longest;
+
+	LOGI << "Replaying " << path << " at " << reader.GetTicksPerSecond() << " ticks per second";
+	while (!broken && !ended) {
+		while (!broken && input.tick == game.tick) {
+			if (!input.command) {
+				ended = true;
+				break;
+			}
+			auto iter = players.find(input.ckey);
+			if (input.command->GetCode() == PlayerCommand::Code::JOIN) {
+				// Joining the game pushes JOIN itself
+				if (iter == players.end()) {
+					auto connection = std::make_shared<Connection>();
+					sptr<Player> player = std::make_shared<Player>(input.ckey);
+					connection->player = player;
+					player->SetConnection(connection);
+					game.AddPlayer(player);
+					players[input.ckey] = player;
+					connections.push_back(connection);
+				}
+			} else if (iter != players.end()) {
+				iter->second->actions.Push(input.command.release());
+			} else {
+				LOGW << "Command of " << input.ckey << " before joining is skipped";
+			}
+			broken = !reader.Next(input);
+		}
+		if (broken || ended)
+			break;
+		if (input.tick < game.tick) {
+			LOGE << "Input recording " << path << " isn't ordered by ticks";
+			broken = true;
+			break;
+		}
+
+		sf::Clock clock;
+		game.update(timestep);
+		sf::Time elapsed = clock.getElapsedTime();
+		total += elapsed;
+		longest = std::max(longest, elapsed);
+
+		for (auto &connection : connections)
+			while (!connection->commandsToClient.Empty())
+				delete connection->commandsToClient.Pop();
+	}
+
+	if (!ended)
+		LOGW << "Input recording " << path << " is truncated, replayed what was read";
+
+	uint64_t ticks = game.tick;
+	sf::Time mean = ticks ? sf::microseconds(total.asMicroseconds() / sf::Int64(ticks)) : sf::Time::Zero;
+	LOGI << "Replayed " << ticks << " ticks (" << ticks / reader.GetTicksPerSecond() << " s of game time) of "
+		<< players.size() << " players in " << total.asMilliseconds() << " ms: mean tick "
+		<< mean.asMicroseconds() << " us, max tick " << longest.asMicroseconds() << " us";
+	return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include <SFML/Config.hpp>
+
+#include <Shared/Types.hpp>
+
+#include <PlayerCommand.hpp>
+
+// Players' commands are recorded when the game thread applies them, so every command is tagged
+// with the tick it affected. Replaying the file against a fresh world repeats the same simulation.
+//
+// File is a sequence of framed packets: size (Uint32, little-endian) and data.
+// The first packet is the header, the rest are commands. Command without a ckey ends the recording.
+
+struct RecordedInput {
+	uint64_t tick;
+	std::string ckey;
+	// Null at the end of the recording
+	uptr<PlayerCommand> command;
+};
+
+class InputRecorder {
+public:
+	InputRecorder(const std::string &path, uint ticksPerSecond);
+	// Mark the end of the recording
+	~InputRecorder();
+
+	bool IsOpen() const { return file.is_open() && file.good(); }
+
+	// Commands are tagged with the tick until the next call
+	void SetTick(uint64_t tick) { this->tick = tick; }
+	void Record(const std::string &ckey, const PlayerCommand &command);
+
+private:
+	std::ofstream file;
+	uint64_t tick;
+};
+
+class InputReader {
+public:
+	// False if there is no file or it isn't a recording
+	bool Open(const std::string &path);
+
+	uint GetTicksPerSecond() const { return ticksPerSecond; }
+	// False if the recording is over or broken
+	bool Next(RecordedInput &input);
+
+private:
+	std::ifstream file;
+	uint ticksPerSecond;
+};
+
+// Headless game repeating a recording tick after tick without waiting.
+// Networking is stubbed out: players have connections without sockets, and everything sent to them is dropped.
+class InputReplay {
+public:
+	// Return false if the recording can't be read
+	static bool Run(const std::string &path);
+};
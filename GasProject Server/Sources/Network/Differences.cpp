@@ -50,7 +50,7 @@ RemoveDiff::RemoveDiff(const Object *object) :
 	Diff(object, Global::DiffType::REMOVE)
 { }
 
-UpdateIconsDiff::UpdateIconsDiff(const Object *object, std::vector<IconInfo> &icons) :
+UpdateIconsDiff::UpdateIconsDiff(const Object *object, const Icons &icons) :
 	Diff(object, Global::DiffType::UPDATE_ICONS),
 	icons(icons)
 { }
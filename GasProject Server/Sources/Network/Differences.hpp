@@ -17,6 +17,8 @@ struct Diff {
     uint id;
 	uint invisibility;
 
+	virtual ~Diff() = default;
+
 	virtual Global::DiffType GetType() const final;
 	bool CheckVisibility(uint visibility) const;
 protected:
@@ -60,9 +62,9 @@ struct MoveDiff : public Diff {
 };
 
 struct UpdateIconsDiff : public Diff {
-	std::vector<IconInfo> icons;
+	Icons icons;
 
-	UpdateIconsDiff(const Object *object, std::vector<IconInfo> &icons);
+	UpdateIconsDiff(const Object *object, const Icons &icons);
 };
 
 struct PlayAnimationDiff : public Diff {
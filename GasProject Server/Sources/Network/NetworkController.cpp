@@ -5,6 +5,7 @@
 #include <plog/Log.h>
 
 #include <Shared/Global.hpp>
+#include <Shared/Trace.hpp>
 #include <Shared/Network/Protocol/ClientCommand.h>
 #include <Shared/Network/Protocol/InputData.h>
 
@@ -16,6 +17,8 @@
 using namespace network::protocol;
 
 void NetworkController::working() {
+    uf::trace::SetThreadName("Network");
+
     sf::TcpListener listener;
     listener.listen(Global::PORT);
 
@@ -72,6 +75,10 @@ void NetworkController::working() {
 
         // Sending to client
         for (auto &connection : connections) {
+            // Idle loop spins every TIMEOUT, so trace only real sending
+            if (connection->commandsToClient.Empty())
+                continue;
+            TRACE_SCOPE("NetworkController::Send");
             while (!connection->commandsToClient.Empty()) {
 				sf::Packet packet;
                 ServerCommand *temp = connection->commandsToClient.Pop();
@@ -118,13 +125,14 @@ bool NetworkController::parsePacket(sf::Packet &packet, sptr<Connection> &connec
 	}
 
 	if (auto *command = dynamic_cast<GamelistRequestClientCommand *>(p.get())) {
-		connection->player->UpdateServerList();
+		if (connection->player)
+			connection->player->UpdateServerList();
 		return true;
 	}
 
 	if (auto *command = dynamic_cast<JoinGameClientCommand *>(p.get())) {
 		if (connection->player) {
-			if (GServer->JoinGame(connection->player)) {
+			if (GServer->JoinGame(connection->player, uint(command->id))) {
 				connection->commandsToClient.Push(new GameJoinSuccessServerCommand());
 			} else {
 				connection->commandsToClient.Push(new GameJoinErrorServerCommand());
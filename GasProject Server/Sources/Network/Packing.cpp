@@ -13,6 +13,13 @@ Packet &operator<<(Packet &packet, ServerCommand *serverCommand) {
     ServerCommand::Code code = serverCommand->GetCode();
     packet << sf::Int32(code);
     switch (code) {
+        case ServerCommand::Code::GAME_LIST: {
+            auto c = dynamic_cast<GameListServerCommand *>(serverCommand);
+            packet << sf::Int32(c->games.size());
+            for (auto &game : c->games)
+                packet << sf::Int32(game.id) << game.title << sf::Int32(game.playersCount);
+            break;
+        }
         case ServerCommand::Code::GRAPHICS_UPDATE: {
             GraphicsUpdateServerCommand *command = dynamic_cast<GraphicsUpdateServerCommand *>(serverCommand);
             packet << sf::Int32(command->options);
@@ -108,8 +115,8 @@ Packet &operator<<(Packet &packet, const Diff &diff) {
 			packet << Int32(diff.id);
 			const UpdateIconsDiff &changeSpriteDiff = dynamic_cast<const UpdateIconsDiff &>(diff);
 			packet << sf::Int32(changeSpriteDiff.icons.size());
-			for (auto &iconInfo : changeSpriteDiff.icons)
-				packet << sf::Int32(iconInfo.id + static_cast<uint32_t>(iconInfo.state));
+			for (auto &icon : changeSpriteDiff.icons)
+				packet << sf::Int32(icon.id + static_cast<uint32_t>(icon.state));
 			break;
 		}
         case Global::DiffType::PLAY_ANIMATION:
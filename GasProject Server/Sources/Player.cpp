@@ -4,8 +4,10 @@
 
 #include <plog/Log.h>
 
+#include <IServer.h>
 #include <IGame.h>
 #include <Chat.h>
+#include <InputRecording.hpp>
 #include <Network/Connection.hpp>
 #include <World/World.hpp>
 #include <World/Tile.hpp>
@@ -18,6 +20,7 @@
 class Server;
 
 Player::Player(std::string ckey) : ckey(ckey) {
+	game = nullptr;
 	control = nullptr;
 }
 
@@ -29,16 +32,20 @@ void Player::SetConnection(sptr<Connection> &connection) {
 }
 
 void Player::UpdateServerList() {
-	if (sptr<Connection> connect = connection.lock())
-		connect->commandsToClient.Push(new GameListServerCommand());
+	auto *command = new GameListServerCommand();
+	for (IGame *game : GServer->GetGames())
+		command->games.push_back({ int(game->GetID()), game->GetTitle(), int(game->GetPlayersCount()) });
+	AddCommandToClient(command);
 }
 
-void Player::JoinToGame() {
+void Player::JoinToGame(IGame *game) {
+	this->game = game;
 	actions.Push(new JoinPlayerCommand);
 }
 
 void Player::ChatMessage(std::string &message) {
-	GGame->GetChat()->AddMessage("<" + ckey + ">" + message);
+	if (game)
+		game->GetChat()->AddMessage("<" + ckey + ">" + message);
 }
 
 void Player::Move(uf::Direction direction) {
@@ -112,9 +119,12 @@ void Player::Update(sf::Time timeElapsed) {
     while (!actions.Empty()) {
         PlayerCommand *temp = actions.Pop();
         if (temp) {
+            if (InputRecorder *recorder = game->GetInputRecorder())
+                recorder->Record(ckey, *temp);
             switch (temp->GetCode()) {
                 case PlayerCommand::Code::JOIN: {
-                    SetControl(GGame->GetStartControl(this));
+                    SetControl(game->GetStartControl(this));
+					verbsHolders["game"] = game;
 					verbsHolders["atmos"] = GetControl()->GetOwner()->GetTile()->GetMap()->GetAtmos();
                     break;
                 }
@@ -141,7 +151,7 @@ void Player::Update(sf::Time timeElapsed) {
                 }
 				case PlayerCommand::Code::DROP: {
 					if (!control) break;
-					if (auto *creature = dynamic_cast<Creature *>(control->GetOwner()))
+					if (auto *creature = control->GetOwner()->As<Creature>())
 						creature->Drop();
 					break;
 				}
@@ -149,14 +159,14 @@ void Player::Update(sf::Time timeElapsed) {
 					if (!control) break;
 					Tile *tile = control->GetOwner()->GetTile();
 					if (tile)
-						GGame->GetWorld()->CreateObject<Wall>(tile);
+						game->GetWorld()->CreateObject<Wall>(tile);
 					break;
 				}
 				case PlayerCommand::Code::GHOST: {
 					if (!control) break;
-					auto *ghost = dynamic_cast<::Ghost *>(control->GetOwner());
+					auto *ghost = control->GetOwner()->As<::Ghost>();
 					if (!ghost) {
-						ghost = GGame->GetWorld()->CreateObject<::Ghost>(control->GetOwner()->GetTile());
+						ghost = game->GetWorld()->CreateObject<::Ghost>(control->GetOwner()->GetTile());
 						ghost->SetHostControl(control);
 						SetControl(ghost->GetComponent<Control>());
 					} else {
@@ -194,7 +204,7 @@ void Player::SetControl(Control *control) {
     SetCamera(new Camera(control->GetOwner()->GetTile()));
     camera->SetPlayer(this);
 	// Get Ability to see Invisibile from the mob (if control owner is mob)
-	if (Creature *creature = dynamic_cast<Creature *>(control->GetOwner()))
+	if (Creature *creature = control->GetOwner()->As<Creature>())
 		camera->SetInvisibleVisibility(creature->GetInvisibleVisibility());
 };
 
@@ -204,6 +214,7 @@ sptr<Connection> Player::GetConnection() {
 	return connection.lock();
 }
 
+IGame *Player::GetGame() { return game; }
 Control *Player::GetControl() { return control; }
 Camera *Player::GetCamera() { return camera.get(); }
 bool Player::IsConnected() { return !connection.expired(); }
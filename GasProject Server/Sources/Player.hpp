@@ -15,8 +15,9 @@
 #include "VerbsHolder.h"
 
 class Server;
-class Game;
+class IGame;
 class NetworkController;
+class InputReplay;
 struct Connection;
 struct ServerCommand;
 
@@ -25,6 +26,7 @@ class Control;
 class Player {
 friend NetworkController;
 friend Server;
+friend InputReplay;
 
 public:
 	explicit Player(std::string ckey);
@@ -33,7 +35,7 @@ public:
 
     /// Client interface
     void UpdateServerList();
-    void JoinToGame();
+    void JoinToGame(IGame *game);
     void ChatMessage(std::string &message);
 
     void Move(uf::Direction);
@@ -65,6 +67,8 @@ public:
 	void SetCamera(Camera *camera);
 
 	sptr<Connection> GetConnection();
+	// Null until the player joins a game
+	IGame *GetGame();
 	Control *GetControl();
 	Camera *GetCamera();
 	bool IsConnected();
@@ -77,6 +81,7 @@ private:
 private:
 	std::string ckey;
 
+	IGame *game;
 	Control *control;
 	uptr<Camera> camera;
 
@@ -16,6 +16,8 @@ struct PlayerCommand {
 		GHOST
     };
 
+    virtual ~PlayerCommand() = default;
+
     virtual const Code GetCode() const final;
 
 protected:
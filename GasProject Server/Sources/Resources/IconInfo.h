@@ -5,13 +5,24 @@
 #include <SFML/System/Time.hpp>
 
 #include <Shared/Global.hpp>
+#include <Shared/SmallVector.hpp>
+
+// Number of the sprite, the same for the server and clients. 0 is no sprite.
+// Sprite names are resolved to ids once by ResourceManager::GetIconID.
+typedef uint32_t IconID;
+
+struct Icon {
+	IconID id;
+	Global::ItemSpriteState state;
+};
+
+// Object's icons: a human has up to 4 with a uniform and items in both hands
+typedef uf::SmallVector<Icon, 4> Icons;
 
 struct IconInfo {
 	uint32_t id;
 	std::string title;
 
-	Global::ItemSpriteState state;
-
 	bool isAnimation;
 	sf::Time animation_time;
 };
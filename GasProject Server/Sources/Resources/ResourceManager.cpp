@@ -22,7 +22,10 @@ bool ResourceManager::Initialize() {
 }
 
 void ResourceManager::loadIcons() {
-	icons.clear();
+	iconIDs.clear();
+	iconsTable.clear();
+	// Ids start from 1
+	iconsTable.emplace_back();
 
 	uint32_t lastIconNum = 0;
 
@@ -34,6 +37,7 @@ void ResourceManager::loadIcons() {
 		config_istr >> config;
 		for (auto icon_config : config["sprites"]) {
 			lastIconNum++;
+			iconsTable.emplace_back();
 			auto title = icon_config.find("sprite");
 			if (title != icon_config.end()) {
 				IconInfo iconInfo = parseIconInfo(icon_config);
@@ -41,7 +45,8 @@ void ResourceManager::loadIcons() {
 				iconInfo.id = lastIconNum;
 				iconInfo.title = title->get<std::string>();
 
-				icons[iconInfo.title] = std::move(iconInfo);
+				iconIDs[iconInfo.title] = lastIconNum;
+				iconsTable[lastIconNum] = std::move(iconInfo);
 			}
 		}
 	}
@@ -65,12 +70,9 @@ IconInfo ResourceManager::parseIconInfo(const json &icon_config) {
 	return iconInfo;
 }
 
-IconInfo ResourceManager::GetIconInfo(const std::string &title, Global::ItemSpriteState state) {
-	auto iter = icons.find(title);
-	if (iter != icons.end()) {
-		auto iconInfo = iter->second;
-		iconInfo.state = state;
-		return iconInfo;
-	}
-	throw std::exception(); // "ResourceManager::GetIconInfo miss."
+IconID ResourceManager::GetIconID(const std::string &title) const {
+	auto iter = iconIDs.find(title);
+	if (iter != iconIDs.end())
+		return iter->second;
+	throw std::exception(); // "ResourceManager::GetIconID miss."
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include <Shared/Global.hpp>
 #include <Shared/JSON.hpp>
@@ -12,13 +13,19 @@ public:
     ResourceManager() = default;
 	bool Initialize();
 
-	IconInfo GetIconInfo(const std::string &spriteName, Global::ItemSpriteState spriteState = Global::ItemSpriteState::DEFAULT);
+	// Look the sprite up by name. Keep the id instead of calling it on every use.
+	// Throws if there is no such sprite.
+	IconID GetIconID(const std::string &spriteName) const;
+	// Id must be got from GetIconID
+	const IconInfo &GetIconInfo(IconID id) const { return iconsTable[id]; }
 
 private:
 	void loadIcons();
 	IconInfo parseIconInfo(const nlohmann::json &icon_config);
 
 private:
-    std::unordered_map<std::string, IconInfo> icons;
+    std::unordered_map<std::string, IconID> iconIDs;
+    // By id, ids of sprites without a name are left empty
+    std::vector<IconInfo> iconsTable;
     std::unordered_map<std::string, IconInfo> sounds;
 };
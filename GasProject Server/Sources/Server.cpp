@@ -23,6 +23,8 @@
 #include <Shared/ErrorHandling.h>
 
 #include "Game.h"
+#include "Global.hpp"
+#include "InputRecording.hpp"
 
 using namespace std;
 using namespace sf;
@@ -38,9 +40,12 @@ Server::Server() :
 	plog::init(plog::verbose, &appender);
 
 	ASSERT_WITH_MSG(RM->Initialize(), "Failed to Initialize ResourceManager!");
+}
+
+void Server::Run(bool recordInput) {
+	for (uint id = 0; id < Global::GamesCount; id++)
+		games.push_back(std::make_unique<Game>(id, recordInput ? GameMode::Recording : GameMode::Normal));
 	networkController->Start();
-	game = std::make_unique<Game>();
-	GGame = game.get();
 	while (true) {
 		sleep(seconds(1));
 	}
@@ -64,15 +69,67 @@ bool Server::Registration(const string &login, const string &password) const {
 	return false;
 }
 
-bool Server::JoinGame(sptr<Player> &player) const {
-	return game->AddPlayer(player);
+bool Server::JoinGame(sptr<Player> &player, uint gameId) const {
+	if (player->GetGame())
+		return false; // already in game
+
+	for (auto &game : games) {
+		if (game->HasPlayer(player->GetCKey()))
+			return game->AddPlayer(player);
+	}
+
+	if (gameId >= games.size()) {
+		LOGW << "Player " << player->GetCKey() << " is trying to join unknown game " << gameId;
+		return false;
+	}
+	return games[gameId]->AddPlayer(player);
+}
+
+IGame *Server::GetGame(uint id) const {
+	if (id >= games.size())
+		return nullptr;
+	return games[id].get();
+}
+
+std::vector<IGame *> Server::GetGames() const {
+	std::vector<IGame *> result;
+	for (auto &game : games)
+		result.push_back(game.get());
+	return result;
 }
 
-IGame *Server::GetGame() const { return static_cast<IGame *>(game.get()); }
 ResourceManager *Server::GetRM() const { return RM.get(); }
 
-int main() {
+namespace {
+
+void printUsage() {
+	std::cout <<
+		"Usage: GasProject_Server [options]\n"
+		"  --record                 record players' commands of every game to " << Global::InputRecordingPrefix << "<game id>.bin\n"
+		"  --replay <path>          replay the recording without networking as fast as possible, then exit\n";
+}
+
+}
+
+int main(int argc, char **argv) {
+	bool recordInput = false;
+	std::string replayPath;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--record") {
+			recordInput = true;
+		} else if (arg == "--replay" && i + 1 < argc) {
+			replayPath = argv[++i];
+		} else {
+			printUsage();
+			return 1;
+		}
+	}
+
 	Server server;
+	if (!replayPath.empty())
+		return InputReplay::Run(replayPath) ? 0 : 1;
+	server.Run(recordInput);
 
 	return 0;
 }
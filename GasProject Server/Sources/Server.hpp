@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <Resources/ResourceManager.hpp>
 #include <Network/NetworkController.hpp>
 #include <Database/UsersDB.hpp>
@@ -12,17 +14,22 @@ class Server : public IServer {
 public:
 	Server();
 
+	// Host the games and serve the clients, never returns
+	void Run(bool recordInput);
+
 // IServer
 	Player *Authorization(const std::string &login, const std::string &password) const override;
 	bool Registration(const std::string &login, const std::string &password) const override;
-	bool JoinGame(sptr<Player> &player) const override;
+	bool JoinGame(sptr<Player> &player, uint gameId) const override;
 
-	IGame *GetGame() const;
+	IGame *GetGame(uint id) const override;
+	std::vector<IGame *> GetGames() const override;
 	ResourceManager *GetRM() const;
 
 private:
 	uptr<UsersDB> UDB;
 	uptr<ResourceManager> RM;
 	uptr<NetworkController> networkController;
-	uptr<Game> game;
+	// Index is the id of the game
+	std::vector<uptr<Game>> games;
 };
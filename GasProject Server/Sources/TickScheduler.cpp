@@ -0,0 +1,120 @@
+#include "TickScheduler.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+
+namespace {
+	// Keep statistics for the last 10 seconds
+	const uint STATS_WINDOW_SECONDS = 10;
+}
+
+float TickStats::Load() const {
+	if (budget == sf::Time::Zero)
+		return 0;
+	return mean.asSeconds() / budget.asSeconds();
+}
+
+std::string TickStats::ToString() const {
+	std::ostringstream ss;
+	ss.precision(3);
+	ss << "budget " << budget.asMicroseconds() / 1000.f << "ms"
+	   << ", mean " << mean.asMicroseconds() / 1000.f << "ms"
+	   << ", p99 " << p99.asMicroseconds() / 1000.f << "ms"
+	   << ", max " << max.asMicroseconds() / 1000.f << "ms"
+	   << ", load " << Load() * 100 << "%"
+	   << ", ticks " << ticks
+	   << ", overruns " << overruns
+	   << ", skipped " << skipped;
+	return ss.str();
+}
+
+TickScheduler::TickScheduler(uint ticksPerSecond, TickOverrunPolicy policy, uint maxCatchUpTicks) :
+	timestep(sf::microseconds(1000000 / std::max(ticksPerSecond, 1u))),
+	policy(policy),
+	maxCatchUpTicks(maxCatchUpTicks),
+	window(std::max(ticksPerSecond, 1u) * STATS_WINDOW_SECONDS),
+	windowPos(0), windowFilled(0),
+	ticks(0), overruns(0), skipped(0)
+{ }
+
+void TickScheduler::Run(const std::atomic<bool> &active, const std::function<void(sf::Time)> &tick) {
+	sf::Clock clock;
+	sf::Time nextTick = clock.getElapsedTime();
+
+	while (active) {
+		sf::Time now = clock.getElapsedTime();
+		if (now < nextTick) {
+			sf::sleep(nextTick - now);
+			continue;
+		}
+
+		// Simulation always advances by fixed step, whatever the real time is
+		tick(timestep);
+
+		sf::Time finished = clock.getElapsedTime();
+		recordTick(finished - now);
+		nextTick += timestep;
+
+		if (finished <= nextTick)
+			continue;
+
+		// We are behind the schedule. Next tick is due immediately,
+		// the question is what to do with ticks which are due too.
+		uint64_t behind = uint64_t((finished - nextTick).asMicroseconds() / timestep.asMicroseconds());
+		uint64_t allowed = policy == TickOverrunPolicy::CatchUp ? maxCatchUpTicks : 0;
+		if (behind > allowed) {
+			uint64_t dropped = behind - allowed;
+			nextTick += timestep * sf::Int64(dropped);
+			recordSkipped(dropped);
+		}
+	}
+}
+
+sf::Time TickScheduler::GetTimestep() const { return timestep; }
+TickOverrunPolicy TickScheduler::GetPolicy() const { return policy; }
+
+TickStats TickScheduler::GetStats() const {
+	std::unique_lock<std::mutex> lock(statsLock);
+
+	TickStats stats;
+	stats.budget = timestep;
+	stats.ticks = ticks;
+	stats.overruns = overruns;
+	stats.skipped = skipped;
+
+	if (!windowFilled)
+		return stats;
+
+	std::vector<sf::Time> durations(window.begin(), window.begin() + windowFilled);
+	lock.unlock();
+
+	sf::Int64 total = 0;
+	for (auto &duration : durations)
+		total += duration.asMicroseconds();
+	stats.mean = sf::microseconds(total / sf::Int64(durations.size()));
+	stats.max = *std::max_element(durations.begin(), durations.end());
+
+	auto p99 = durations.begin() + (durations.size() - 1) * 99 / 100;
+	std::nth_element(durations.begin(), p99, durations.end());
+	stats.p99 = *p99;
+
+	return stats;
+}
+
+void TickScheduler::recordTick(sf::Time duration) {
+	std::unique_lock<std::mutex> lock(statsLock);
+	window[windowPos] = duration;
+	windowPos = (windowPos + 1) % window.size();
+	windowFilled = std::min(windowFilled + 1, window.size());
+	ticks++;
+	if (duration > timestep)
+		overruns++;
+}
+
+void TickScheduler::recordSkipped(uint64_t count) {
+	std::unique_lock<std::mutex> lock(statsLock);
+	skipped += count;
+}
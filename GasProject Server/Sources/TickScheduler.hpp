@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <SFML/System/Time.hpp>
+
+#include <Shared/Types.hpp>
+
+// What to do with ticks missed because previous ticks overran the budget
+enum class TickOverrunPolicy : char {
+	CatchUp, // run missed ticks back-to-back, but not more than max catch-up ticks
+	Skip     // drop missed ticks, simulation time slows down instead
+};
+
+struct TickStats {
+	sf::Time budget;
+	// Over the last window
+	sf::Time mean;
+	sf::Time p99;
+	sf::Time max;
+	// Since start
+	uint64_t ticks;
+	uint64_t overruns;
+	uint64_t skipped;
+
+	// Mean tick duration relative to the budget. More than 1 means CPU-bound.
+	float Load() const;
+	std::string ToString() const;
+};
+
+class TickScheduler {
+public:
+	explicit TickScheduler(uint ticksPerSecond,
+	                       TickOverrunPolicy policy = TickOverrunPolicy::CatchUp,
+	                       uint maxCatchUpTicks = 5);
+
+	// Call tick with fixed timestep while active. Blocks the calling thread.
+	void Run(const std::atomic<bool> &active, const std::function<void(sf::Time)> &tick);
+
+	sf::Time GetTimestep() const;
+	TickOverrunPolicy GetPolicy() const;
+
+	// Thread safe
+	TickStats GetStats() const;
+
+private:
+	void recordTick(sf::Time duration);
+	void recordSkipped(uint64_t count);
+
+private:
+	const sf::Time timestep;
+	const TickOverrunPolicy policy;
+	const uint maxCatchUpTicks;
+
+	mutable std::mutex statsLock;
+	std::vector<sf::Time> window; // ring buffer of last tick durations
+	size_t windowPos;
+	size_t windowFilled;
+	uint64_t ticks;
+	uint64_t overruns;
+	uint64_t skipped;
+};
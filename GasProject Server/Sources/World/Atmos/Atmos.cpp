@@ -1,36 +1,98 @@
 #include "Atmos.hpp"
 
+#include <algorithm>
+
 #include <plog/Log.h>
 
+#include <Shared/Trace.hpp>
+
 #include <IServer.h>
 #include <Player.hpp>
 #include <World/World.hpp>
+#include <World/Map.hpp>
 #include <World/Tile.hpp>
 
 #include "AtmosOverlayWindowSink.h"
+#include "AtmosWorker.hpp"
+
+const sf::Time Atmos::SETTLE_TIME = sf::seconds(1);
 
 void ToggleAtmosOverlayVerb(Player *player) {
 	player->OpenWindow<AtmosOverlayWindowSink>();
 }
 
-Atmos::Atmos(Map* map) : map(map) {
+Atmos::Atmos(Map* map) :
+    map(map),
+    activeLocalesCount(0), sleepingLocalesCount(0),
+    searchStamp(0)
+{
 	AddVerb("toggleoverlay", &ToggleAtmosOverlayVerb);
 }
 
 void Atmos::Update(sf::Time timeElapsed) {
-    for (auto iter = locales.begin(); iter != locales.end(); ) {
-        Locale *locale = iter->get();
+    TRACE_SCOPE("Atmos::Update");
+    activeMixtures.clear();
+    for (uint i = 0; i < awakeLocales.size(); ) {
+        Locale *locale = awakeLocales[i];
+        // Both take the locale out of the awake ones, the next one takes its place
         if (locale->IsEmpty()) {
-            iter = locales.erase(iter);
-        } else {
-            locale->Update(timeElapsed);
-            iter++;
+            eraseLocale(locale->slot);
+            continue;
+        }
+        locale->Update(timeElapsed);
+        if (locale->IsSettled()) {
+            sleepLocale(locale);
+            continue;
         }
+        activeMixtures.push_back(locale->mixture);
+        i++;
+    }
+
+    activeLocalesCount = awakeLocales.size();
+    sleepingLocalesCount = locales.size() - awakeLocales.size();
+}
+
+void Atmos::Fill(AtmosFrame &frame) const {
+    TRACE_SCOPE("Atmos::Fill");
+    frame.mixtureIndices.assign(activeMixtures.begin(), activeMixtures.end());
+    frame.mixtureGenerations.resize(activeMixtures.size());
+    frame.ventRates.resize(activeMixtures.size());
+    frame.keeps.resize(activeMixtures.size());
+    for (size_t i = 0; i < activeMixtures.size(); i++) {
+        uint index = activeMixtures[i];
+        frame.mixtureGenerations[i] = mixtureGenerations[index];
+        frame.ventRates[i] = ventRates[index];
+    }
+}
+
+void Atmos::Apply(const AtmosFrame &frame) {
+    TRACE_SCOPE("Atmos::Apply");
+    for (size_t i = 0; i < frame.mixtureIndices.size(); i++) {
+        uint index = frame.mixtureIndices[i];
+        // The locale was removed or merged meanwhile, its gas is somewhere else now
+        if (mixtureGenerations[index] != frame.mixtureGenerations[i])
+            continue;
+        mixtures[index].Scale(frame.keeps[i]);
     }
 }
 
-void Atmos::CreateLocale(Tile *tile) {
+void Atmos::Step(AtmosFrame &frame) {
+    TRACE_SCOPE("Atmos::Step");
+    // Space is an empty reservoir: every locale loses gas in proportion to its pressure and breaches.
+    // Plain loop over the packed arrays without branches, so the compiler vectorizes it.
+    // Sleeping locales are in equilibrium, only the awake ones are copied to the frame.
+    const float *rate = frame.ventRates.data();
+    float *keep = frame.keeps.data();
+    for (size_t i = 0; i < frame.ventRates.size(); i++)
+        keep[i] = std::max(0.f, 1.f - VENT_RATE * rate[i] * frame.seconds);
+}
+
+Locale *Atmos::CreateLocale(Tile *tile) {
     locales.push_back(std::make_unique<Locale>(this, tile));
+    Locale *locale = locales.back().get();
+    locale->slot = uint(locales.size() - 1);
+    locale->Wake();
+    return locale;
 }
 
 void Atmos::RemoveLocale(Locale *locale) {
@@ -38,15 +100,195 @@ void Atmos::RemoveLocale(Locale *locale) {
         LOGE << "Error: try to remove nullptr locale from Atmos (Atmos::RemoveLocale)";
         return;
     }
-    for (auto iter = locales.begin(); iter != locales.end(); iter++) {
-        if (iter->get() == locale) {
-            for (auto tile : locale->tiles) {
-                tile->CheckLocale();
+    if (locale->slot >= locales.size() || locales[locale->slot].get() != locale) {
+        LOGW << "Warning: try to remove locale from Atmos which doesn't exist (Atmos::RemoveLocale)";
+        return;
+    }
+    for (auto tile : locale->tiles) {
+        tile->CheckLocale();
+    }
+    locale->Clear();
+    eraseLocale(locale->slot);
+}
+
+void Atmos::CheckSplit(Locale *locale, apos pos) {
+    TRACE_SCOPE("Atmos::CheckSplit");
+    const rpos sides[] = { rpos(1, 0, 0), rpos(-1, 0, 0), rpos(0, 1, 0), rpos(0, -1, 0) };
+
+    // Searches start from every side of the tile and go by turns, one tile a step.
+    // Searches which meet are in one part. A part is known when all its searches are exhausted,
+    // so the search stops when at most one part is still growing, without walking through it.
+    struct Search {
+        std::vector<Tile *> visited;
+        size_t next;
+        uint part; // union-find over the searches
+    };
+    Search searches[4];
+    uint count = 0;
+
+    searchStamp++;
+    for (auto side : sides) {
+        Tile *tile = map->FindTile(pos + side);
+        if (!tile || tile->GetLocale() != locale)
+            continue;
+        tile->searchStamp = searchStamp;
+        tile->searchIndex = count;
+        searches[count].visited.push_back(tile);
+        searches[count].next = 0;
+        searches[count].part = count;
+        count++;
+    }
+    if (count < 2)
+        return;
+
+    auto findPart = [&searches](uint i) {
+        while (searches[i].part != i)
+            i = searches[i].part = searches[searches[i].part].part;
+        return i;
+    };
+
+    while (true) {
+        for (uint i = 0; i < count; i++) {
+            Search &search = searches[i];
+            if (search.next == search.visited.size())
+                continue;
+            Tile *tile = search.visited[search.next++];
+            for (auto side : sides) {
+                Tile *neighbour = map->FindTile(tile->GetPos() + side);
+                if (!neighbour || neighbour->GetLocale() != locale)
+                    continue;
+                if (neighbour->searchStamp != searchStamp) {
+                    neighbour->searchStamp = searchStamp;
+                    neighbour->searchIndex = i;
+                    search.visited.push_back(neighbour);
+                } else {
+                    uint a = findPart(i), b = findPart(neighbour->searchIndex);
+                    if (a != b)
+                        searches[b].part = a;
+                }
             }
-            locale->Clear();
-            locales.erase(iter);
+        }
+
+        uint parts = 0, growing = 0;
+        for (uint i = 0; i < count; i++) {
+            if (findPart(i) != i)
+                continue;
+            parts++;
+            for (uint j = 0; j < count; j++)
+                if (findPart(j) == i && searches[j].next < searches[j].visited.size()) {
+                    growing++;
+                    break;
+                }
+        }
+        if (parts < 2)
             return;
+        if (growing < 2)
+            break;
+    }
+
+    // The growing part or the biggest one stays in the locale, the rest are cut off
+    uint kept = count;
+    size_t keptSize = 0;
+    for (uint i = 0; i < count; i++) {
+        if (findPart(i) != i)
+            continue;
+        size_t size = 0;
+        bool isGrowing = false;
+        for (uint j = 0; j < count; j++)
+            if (findPart(j) == i) {
+                size += searches[j].visited.size();
+                isGrowing |= searches[j].next < searches[j].visited.size();
+            }
+        if (isGrowing) {
+            kept = i;
+            break;
+        }
+        if (kept == count || size > keptSize) {
+            kept = i;
+            keptSize = size;
         }
     }
-    LOGW << "Warning: try to remove locale from Atmos which doesn't exist (Atmos::RemoveLocale)";
+
+    for (uint i = 0; i < count; i++) {
+        if (findPart(i) != i || i == kept)
+            continue;
+        std::vector<Tile *> part;
+        for (uint j = 0; j < count; j++)
+            if (findPart(j) == i)
+                part.insert(part.end(), searches[j].visited.begin(), searches[j].visited.end());
+        locale->Split(part);
+    }
+}
+
+void Atmos::eraseLocale(uint slot) {
+    if (locales[slot]->awake)
+        sleepLocale(locales[slot].get());
+    // Order of locales doesn't matter
+    std::swap(locales[slot], locales.back());
+    locales[slot]->slot = slot;
+    locales.pop_back();
+}
+
+void Atmos::FillWithAir(Tile *tile) {
+    if (!tile)
+        return;
+    // Walls are warmed too. Tiles warmed or cooled already are left alone.
+    Heat *heat = map->GetHeat();
+    if (heat->GetTemperature(tile) == Heat::SPACE_TEMPERATURE)
+        heat->SetTemperature(tile, Heat::ROOM_TEMPERATURE);
+    if (tile->GetLocale() || !tile->isAtmosAvailable())
+        return;
+    tile->gases.Clear();
+    tile->gases[Gas::Oxygen] = 0.21f * ONE_ATMOSPHERE;
+    tile->gases[Gas::Nitrogen] = 0.79f * ONE_ATMOSPHERE;
+}
+
+void Atmos::AddGas(Tile *tile, Gas gas, pressure amount) {
+    if (!tile)
+        return;
+    if (Locale *locale = tile->GetLocale()) {
+        locale->mix()[gas] += amount;
+        locale->Wake();
+    } else if (tile->isAtmosAvailable()) {
+        tile->gases[gas] += amount;
+    }
+}
+
+size_t Atmos::GetActiveLocalesCount() const { return activeLocalesCount; }
+size_t Atmos::GetSleepingLocalesCount() const { return sleepingLocalesCount; }
+
+void Atmos::wakeLocale(Locale *locale) {
+    if (locale->awake)
+        return;
+    locale->awake = true;
+    locale->awakeIndex = uint(awakeLocales.size());
+    awakeLocales.push_back(locale);
+}
+
+void Atmos::sleepLocale(Locale *locale) {
+    Locale *last = awakeLocales.back();
+    awakeLocales[locale->awakeIndex] = last;
+    last->awakeIndex = locale->awakeIndex;
+    awakeLocales.pop_back();
+    locale->awake = false;
+}
+
+uint Atmos::allocateMixture() {
+    if (!freeMixtures.empty()) {
+        uint index = freeMixtures.back();
+        freeMixtures.pop_back();
+        return index;
+    }
+    mixtures.emplace_back();
+    ventRates.push_back(0);
+    mixtureGenerations.push_back(0);
+    return uint(mixtures.size() - 1);
+}
+
+void Atmos::releaseMixture(uint index) {
+    // Free mixtures stay in the arrays empty, exchange doesn't change them
+    mixtures[index].Clear();
+    ventRates[index] = 0;
+    mixtureGenerations[index]++;
+    freeMixtures.push_back(index);
 }
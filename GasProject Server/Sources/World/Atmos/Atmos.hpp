@@ -1,6 +1,7 @@
 #pragma once
 
-#include <list>
+#include <atomic>
+#include <vector>
 
 #include <VerbsHolder.h>
 #include <Shared/Types.hpp>
@@ -10,17 +11,80 @@
 
 class Map;
 class Tile;
+class WorldSnapshot;
+struct AtmosFrame;
 
+// Every locale is one well-mixed volume of gas. Its mixture is kept in a packed array of all mixtures,
+// so exchange passes run over contiguous memory however many locales there are.
+// Exchange is computed by AtmosWorker over copies of the mixtures of the awake locales.
 class Atmos : public VerbsHolder {
 public:
+    friend WorldSnapshot;
+    friend Locale;
+
+    static constexpr pressure ONE_ATMOSPHERE = 101.325f;
+    // Fraction of the pressure leaking through one breach per second
+    static constexpr float VENT_RATE = 0.5f;
+    // Locales with smaller pressure differences are in equilibrium, kPa
+    static constexpr pressure EQUILIBRIUM_GRADIENT = 0.1f;
+    // Locales fall asleep only after this long without changes
+    static const sf::Time SETTLE_TIME;
+
     explicit Atmos(Map *map);
 
     void Update(sf::Time timeElapsed);
+    // Copy mixtures of the awake locales to the frame. Call from the game thread after Update.
+    void Fill(AtmosFrame &frame) const;
+    // Add changes computed for the frame to the mixtures which are still used
+    void Apply(const AtmosFrame &frame);
+    // Called by the worker, reads and writes the frame only
+    static void Step(AtmosFrame &frame);
 
-    void CreateLocale(Tile *);
+    Locale *CreateLocale(Tile *);
+    // Tiles of the locale are left without a locale and are checked again
     void RemoveLocale(Locale *);
+    // Call when the tile at the position has left the locale: the rest may be disconnected now.
+    // Cut off parts become new locales. Cost depends on the size of the smaller parts only.
+    void CheckSplit(Locale *locale, apos pos);
+
+    // Put standard station air of room temperature on the tile if it's atmos-available. For filling new maps.
+    // Tiles in locales are left alone, their gas is simulated already.
+    void FillWithAir(Tile *tile);
+    // Gas source: add the amount (kPa on one tile) to the tile or its locale, waking it
+    void AddGas(Tile *tile, Gas gas, pressure amount);
+
+    // Only awake locales cost anything per tick.
+    // Thread safe. Counted on the last update.
+    size_t GetActiveLocalesCount() const;
+    size_t GetSleepingLocalesCount() const;
 
 private:
     Map *map;
-    std::list<uptr<Locale>> locales;
+
+    // By Locale::mixture. Declared before locales, which release their mixtures when destroyed.
+    std::vector<GasMixture> mixtures;
+    // Share of the mixture leaking per second per unit of VENT_RATE, counted by locales
+    std::vector<float> ventRates;
+    std::vector<uint> freeMixtures;
+    // Increased when the mixture is released
+    std::vector<uint> mixtureGenerations;
+
+    // In any order, Locale::slot is the index of the locale here
+    std::vector<uptr<Locale>> locales;
+    void eraseLocale(uint slot);
+    // In any order, Locale::awakeIndex is the index of the locale here
+    std::vector<Locale *> awakeLocales;
+    // Mixtures of the awake locales for the exchange
+    std::vector<uint> activeMixtures;
+    void wakeLocale(Locale *locale);
+    void sleepLocale(Locale *locale);
+
+    std::atomic<size_t> activeLocalesCount;
+    std::atomic<size_t> sleepingLocalesCount;
+
+    // Marks tiles visited by the current CheckSplit
+    uint searchStamp;
+
+    uint allocateMixture();
+    void releaseMixture(uint index);
 };
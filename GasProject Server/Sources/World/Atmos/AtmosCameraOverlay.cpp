@@ -1,5 +1,7 @@
 #include "AtmosCameraOverlay.h"
 
+#include <cmath>
+
 #include <World/Tile.hpp>
 #include <World/Atmos/Locale.hpp>
 
@@ -24,7 +26,7 @@ bool AtmosCameraOverlay::IsShouldBeUpdated(sf::Time timeElapsed) const {
 
 using namespace network::protocol;
 
-OverlayInfo AtmosCameraOverlay::GetOverlayInfo(Tile tile) const {
+OverlayInfo AtmosCameraOverlay::GetOverlayInfo(const Tile &tile) const {
 	OverlayInfo result;
 
 	switch (mode) {
@@ -38,6 +40,21 @@ OverlayInfo AtmosCameraOverlay::GetOverlayInfo(Tile tile) const {
 			}
 			break;
 		}
+		case AtmosCameraOverlayMode::Pressure: {
+			result.text = std::to_string(int(std::round(tile.GetTotalPressure())));
+			break;
+		}
+		case AtmosCameraOverlayMode::Temperature: {
+			// Celsius are easier to read for room temperatures
+			result.text = std::to_string(int(std::round(tile.GetTemperature() - 273.15f)));
+			break;
+		}
+		case AtmosCameraOverlayMode::PartialGasPressure: {
+			// Oxygen and nitrogen, the rest of the gases is rare
+			result.text = std::to_string(int(std::round(tile.GetPressure(Gas::Oxygen)))) + "/" +
+			              std::to_string(int(std::round(tile.GetPressure(Gas::Nitrogen))));
+			break;
+		}
 		default: {
 			result.text = "NULL";
 			break;
@@ -0,0 +1,81 @@
+#include "AtmosWorker.hpp"
+
+#include <algorithm>
+
+#include <Shared/Trace.hpp>
+
+#include <Global.hpp>
+
+#include "Atmos.hpp"
+
+namespace {
+
+// Steps run along with the game thread and view builders of every game, so a game gets half of its share
+uint heatThreads() {
+    uint hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    uint perGame = std::max(hardwareThreads / std::max(Global::GamesCount, 1u), 1u);
+    // Atmos thread takes part in the work
+    return std::max(perGame / 2, 2u) - 1;
+}
+
+}
+
+AtmosWorker::AtmosWorker() :
+    workers(heatThreads()),
+    submitted(false),
+    computing(false),
+    stopping(false)
+{
+    thread.reset(new std::thread(&AtmosWorker::working, this));
+}
+
+AtmosWorker::~AtmosWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    frameSubmitted.notify_one();
+    thread->join();
+}
+
+AtmosFrame &AtmosWorker::GetFrame() { return frame; }
+
+void AtmosWorker::Submit() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        submitted = true;
+        computing = true;
+    }
+    frameSubmitted.notify_one();
+}
+
+bool AtmosWorker::Wait() {
+    TRACE_SCOPE("AtmosWorker::Wait");
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!submitted)
+        return false;
+    frameFinished.wait(lock, [this] { return !computing; });
+    submitted = false;
+    return true;
+}
+
+void AtmosWorker::working() {
+    uf::trace::SetThreadName("Atmos");
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        frameSubmitted.wait(lock, [this] { return computing || stopping; });
+        // Frame submitted before stopping is finished first
+        if (!computing)
+            return;
+        lock.unlock();
+        {
+            TRACE_SCOPE("AtmosWorker::Step");
+            Atmos::Step(frame);
+            Heat::Step(frame, workers);
+        }
+        lock.lock();
+        computing = false;
+        frameFinished.notify_one();
+    }
+}
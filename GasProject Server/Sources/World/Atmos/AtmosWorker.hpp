@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Shared/Types.hpp>
+#include <Shared/IFaces/INonCopyable.h>
+#include <Shared/ThreadPool.hpp>
+
+#include <World/Map.hpp>
+
+#include "Gases.hpp"
+#include "Heat.hpp"
+
+// State for one step of the worker, and results of the step.
+// Mixtures are copied: the game goes on changing them while the frame is computed,
+// so results are applied in a way which stays right whatever was changed meanwhile.
+// Chunks own their heat buffers, the game doesn't write the ones the worker reads until the frame is applied.
+struct AtmosFrame {
+    float seconds;
+
+    // Mixtures of the awake locales by index in Atmos::mixtures
+    std::vector<uint> mixtureIndices;
+    // Mixtures may be released and reused while the frame is computed, results for them are dropped
+    std::vector<uint> mixtureGenerations;
+    std::vector<float> ventRates;
+    // Results: share of every mixture left after venting. Locales may be split or lose tiles meanwhile,
+    // a share is right for every part of them, unlike an amount.
+    std::vector<float> keeps;
+
+    // Awake chunks, the worker writes their next temperatures and heat deltas only
+    std::vector<MapChunk *> chunks;
+    // Neighbours of the chunks to the left, right, top and bottom, null for untouched ones
+    std::vector<std::array<const MapChunk *, 4>> neighbours;
+};
+
+// Dedicated thread computing the numeric part of atmos: venting of locales and heat conduction.
+// The game thread submits a frame at the end of the map update and applies it at the next tick,
+// so the step runs while the game does everything else. Structural changes (locales merging and splitting)
+// stay on the game thread, they change tiles everybody reads.
+class AtmosWorker : public INonCopyable {
+public:
+    AtmosWorker();
+    // Submitted frame is finished before stopping
+    ~AtmosWorker();
+
+    // Don't touch the frame between Submit and Wait
+    AtmosFrame &GetFrame();
+    void Submit();
+    // Wait for the submitted frame. False if there is no frame submitted.
+    bool Wait();
+
+private:
+    void working();
+
+private:
+    uptr<std::thread> thread;
+    // Heat of many chunks is split between them
+    uf::ThreadPool workers;
+
+    std::mutex mutex;
+    std::condition_variable frameSubmitted;
+    std::condition_variable frameFinished;
+    // Protected by mutex
+    bool submitted;
+    bool computing;
+    bool stopping;
+
+    AtmosFrame frame;
+};
@@ -10,4 +10,41 @@ enum class Gas : char {
     Count
 };
 
-typedef float pressure;
\ No newline at end of file
+typedef float pressure;
+
+// Amount of every gas as partial pressure summed over tiles (kPa * tiles).
+// Padded to 8 lanes and aligned, so fixed-size loops over mixtures compile to vector instructions.
+struct alignas(32) GasMixture {
+    static const int LANES = 8;
+
+    pressure gases[LANES];
+
+    GasMixture() : gases() { }
+
+    pressure &operator[](Gas gas) { return gases[int(gas)]; }
+    pressure operator[](Gas gas) const { return gases[int(gas)]; }
+
+    pressure Total() const {
+        pressure total = 0;
+        for (int i = 0; i < LANES; i++)
+            total += gases[i];
+        return total;
+    }
+
+    void Add(const GasMixture &other) {
+        for (int i = 0; i < LANES; i++)
+            gases[i] += other.gases[i];
+    }
+
+    void Scale(float factor) {
+        for (int i = 0; i < LANES; i++)
+            gases[i] *= factor;
+    }
+
+    void Clear() {
+        for (int i = 0; i < LANES; i++)
+            gases[i] = 0;
+    }
+};
+
+static_assert(int(Gas::Count) <= GasMixture::LANES, "Gases don't fit GasMixture");
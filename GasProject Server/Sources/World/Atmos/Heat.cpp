@@ -0,0 +1,192 @@
+#include "Heat.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Shared/ThreadPool.hpp>
+#include <Shared/Trace.hpp>
+
+#include <World/Map.hpp>
+#include <World/Tile.hpp>
+
+#include "AtmosWorker.hpp"
+
+namespace {
+
+// Fewer chunks aren't worth waking the workers
+const size_t PARALLEL_CHUNKS = 16;
+
+float conductivityOf(uint8_t state) {
+    if (state & MapChunk::FULL_BLOCKED)
+        return Heat::WALL_CONDUCTIVITY;
+    if (state & MapChunk::FLOOR)
+        return Heat::FLOOR_CONDUCTIVITY;
+    return Heat::SPACE_CONDUCTIVITY;
+}
+
+}
+
+Heat::Heat(Map *map) : map(map), lastFrameChunks(0), stepping(false) { }
+
+void Heat::Fill(AtmosFrame &frame) {
+    TRACE_SCOPE("Heat::Fill");
+    // Worker reads the state of neighbours too, so every changed chunk is synced
+    for (MapChunk *chunk : changedChunks) {
+        chunk->heatStateChanged = false;
+        for (uint tile = 0; tile < MapChunk::TILES; tile++) {
+            chunk->heatState[tile] = chunk->state[tile];
+            chunk->conductivities[tile] = conductivityOf(chunk->state[tile]);
+        }
+    }
+    changedChunks.clear();
+
+    frame.chunks.swap(awakeChunks);
+    awakeChunks.clear();
+    lastFrameChunks = frame.chunks.size();
+    frame.neighbours.resize(frame.chunks.size());
+    uint chunksPerLevel = map->chunksX * map->chunksY;
+    for (size_t i = 0; i < frame.chunks.size(); i++) {
+        MapChunk *chunk = frame.chunks[i];
+        chunk->heatAwake = false;
+        int x = int(chunk->index % map->chunksX);
+        int y = int(chunk->index % chunksPerLevel / map->chunksX);
+        uint z = chunk->index / chunksPerLevel;
+        frame.neighbours[i] = { findChunk(x - 1, y, z), findChunk(x + 1, y, z), findChunk(x, y - 1, z), findChunk(x, y + 1, z) };
+    }
+    stepping = !frame.chunks.empty();
+}
+
+void Heat::Apply(const AtmosFrame &frame) {
+    TRACE_SCOPE("Heat::Apply");
+    for (MapChunk *chunk : frame.chunks) {
+        std::swap(chunk->temperatures, chunk->nextTemperatures);
+        // Changes spread to the neighbour chunks by the next step
+        if (chunk->heatDelta > EQUILIBRIUM_DELTA) {
+            Wake(chunk);
+            wakeNeighbours(chunk);
+        }
+    }
+    stepping = false;
+
+    for (auto &pending : pendingTemperatures)
+        SetTemperature(pending.first, pending.second);
+    pendingTemperatures.clear();
+}
+
+void Heat::Step(AtmosFrame &frame, uf::ThreadPool &workers) {
+    TRACE_SCOPE("Heat::Step");
+    // Explicit scheme is stable while a tile gives away no more than it has.
+    // Longer ticks are slowed down rather than blown up.
+    float seconds = std::min(frame.seconds, 0.25f / FLOOR_CONDUCTIVITY);
+
+    // Steps read only published temperatures and write only next ones of their own chunk
+    if (frame.chunks.size() >= PARALLEL_CHUNKS) {
+        workers.ParallelFor(frame.chunks.size(), [&frame, seconds](size_t i) {
+            conduct(frame.chunks[i], frame.neighbours[i], seconds);
+        });
+    } else {
+        for (size_t i = 0; i < frame.chunks.size(); i++)
+            conduct(frame.chunks[i], frame.neighbours[i], seconds);
+    }
+}
+
+temperature Heat::GetTemperature(const Tile *tile) const {
+    // Floor could be removed after the last step
+    if (!tile->hasFloor())
+        return SPACE_TEMPERATURE;
+    return tile->chunk->temperatures[tile->index];
+}
+
+void Heat::SetTemperature(Tile *tile, temperature value) {
+    if (stepping) {
+        pendingTemperatures.emplace_back(tile, value);
+        return;
+    }
+    if (!tile->hasFloor())
+        return;
+    tile->chunk->temperatures[tile->index] = value;
+    Wake(tile->chunk);
+}
+
+void Heat::OnStateChanged(MapChunk *chunk) {
+    if (!chunk->heatStateChanged) {
+        chunk->heatStateChanged = true;
+        changedChunks.push_back(chunk);
+    }
+    Wake(chunk);
+}
+
+void Heat::Wake(MapChunk *chunk) {
+    if (chunk->heatAwake)
+        return;
+    chunk->heatAwake = true;
+    awakeChunks.push_back(chunk);
+}
+
+size_t Heat::GetActiveChunksCount() const { return lastFrameChunks; }
+
+void Heat::conduct(MapChunk *chunk, const std::array<const MapChunk *, 4> &neighbours, float seconds) {
+    const int SIZE = int(MapChunk::SIZE);
+    // Chunk with a border of one tile from the neighbours, corners aren't used by the stencil
+    const int PADDED = SIZE + 2;
+    temperature t[PADDED * PADDED];
+    float c[PADDED * PADDED];
+    std::fill(t, t + PADDED * PADDED, SPACE_TEMPERATURE);
+    std::fill(c, c + PADDED * PADDED, SPACE_CONDUCTIVITY);
+
+    for (int y = 0; y < SIZE; y++) {
+        std::copy(chunk->temperatures + y * SIZE, chunk->temperatures + (y + 1) * SIZE, t + (y + 1) * PADDED + 1);
+        std::copy(chunk->conductivities + y * SIZE, chunk->conductivities + (y + 1) * SIZE, c + (y + 1) * PADDED + 1);
+    }
+
+    // Border of a neighbour: its tiles from the given one with the step, to the padded cells from the given one with the step
+    auto copyBorder = [&](const MapChunk *neighbour, int from, int step, int to, int toStep) {
+        if (!neighbour)
+            return;
+        for (int i = 0; i < SIZE; i++) {
+            t[to + i * toStep] = neighbour->temperatures[from + i * step];
+            c[to + i * toStep] = neighbour->conductivities[from + i * step];
+        }
+    };
+    copyBorder(neighbours[0], SIZE - 1, SIZE, PADDED, PADDED);
+    copyBorder(neighbours[1], 0, SIZE, PADDED + PADDED - 1, PADDED);
+    copyBorder(neighbours[2], (SIZE - 1) * SIZE, 1, 1, 1);
+    copyBorder(neighbours[3], 0, 1, (PADDED - 1) * PADDED + 1, 1);
+
+    // Rows are independent and branch-free, so the inner loop is vectorized
+    temperature delta = 0;
+    for (int y = 0; y < SIZE; y++) {
+        const temperature *row = t + (y + 1) * PADDED + 1;
+        const float *conductivity = c + (y + 1) * PADDED + 1;
+        const uint8_t *state = chunk->heatState + y * SIZE;
+        temperature *next = chunk->nextTemperatures + y * SIZE;
+        for (int x = 0; x < SIZE; x++) {
+            float own = conductivity[x];
+            temperature flux =
+                std::min(own, conductivity[x - 1]) * (row[x - 1] - row[x]) +
+                std::min(own, conductivity[x + 1]) * (row[x + 1] - row[x]) +
+                std::min(own, conductivity[x - PADDED]) * (row[x - PADDED] - row[x]) +
+                std::min(own, conductivity[x + PADDED]) * (row[x + PADDED] - row[x]);
+            // Tiles without floor are space and stay cold
+            next[x] = (state[x] & MapChunk::FLOOR) ? row[x] + seconds * flux : SPACE_TEMPERATURE;
+            delta = std::max(delta, std::abs(next[x] - row[x]));
+        }
+    }
+    chunk->heatDelta = delta;
+}
+
+void Heat::wakeNeighbours(const MapChunk *chunk) {
+    uint chunksPerLevel = map->chunksX * map->chunksY;
+    int x = int(chunk->index % map->chunksX);
+    int y = int(chunk->index % chunksPerLevel / map->chunksX);
+    uint z = chunk->index / chunksPerLevel;
+    for (MapChunk *neighbour : { findChunk(x - 1, y, z), findChunk(x + 1, y, z), findChunk(x, y - 1, z), findChunk(x, y + 1, z) })
+        if (neighbour)
+            Wake(neighbour);
+}
+
+MapChunk *Heat::findChunk(int x, int y, uint z) const {
+    if (x < 0 || y < 0 || uint(x) >= map->chunksX || uint(y) >= map->chunksY)
+        return nullptr;
+    return map->chunks[(z * map->chunksY + uint(y)) * map->chunksX + uint(x)].load(std::memory_order_acquire);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include <Shared/Types.hpp>
+
+namespace uf {
+class ThreadPool;
+}
+
+class Map;
+class Tile;
+struct MapChunk;
+struct AtmosFrame;
+
+typedef float temperature;
+
+// Heat conduction between tiles. Temperatures are kept in packed arrays of map chunks,
+// every step applies a 5-point stencil to a chunk at once, reading the borders of the neighbour chunks.
+// Chunks are stepped only while their temperatures change, settled chunks cost nothing.
+// Steps are computed by AtmosWorker into the second temperature buffers of the chunks.
+class Heat {
+public:
+    // Untouched chunks and tiles without floor are space of this temperature, K
+    static constexpr temperature SPACE_TEMPERATURE = 2.7f;
+    static constexpr temperature ROOM_TEMPERATURE = 293.15f;
+    // Share of the temperature difference passing between two tiles per second.
+    // Pair of tiles conducts as the worse of both materials.
+    static constexpr float FLOOR_CONDUCTIVITY = 4.f;
+    static constexpr float WALL_CONDUCTIVITY = 0.5f;
+    // Vacuum doesn't conduct, otherwise the station would never settle
+    static constexpr float SPACE_CONDUCTIVITY = 0.f;
+    // Chunks with smaller changes per step fall asleep, K
+    static constexpr temperature EQUILIBRIUM_DELTA = 0.01f;
+
+    explicit Heat(Map *map);
+
+    // Submit awake chunks and sync the state of changed ones. Call from the game thread only.
+    void Fill(AtmosFrame &frame);
+    // Publish the temperatures computed for the frame and wake chunks which still change
+    void Apply(const AtmosFrame &frame);
+    // Called by the worker, writes the next temperatures of the frame's chunks only
+    static void Step(AtmosFrame &frame, uf::ThreadPool &workers);
+
+    temperature GetTemperature(const Tile *tile) const;
+    // Heat source or initial temperature. Space tiles keep the space temperature.
+    // While a frame is computed the value is set when the frame is applied.
+    void SetTemperature(Tile *tile, temperature value);
+    // Call when floors or walls of the chunk's tiles are changed
+    void OnStateChanged(MapChunk *chunk);
+    void Wake(MapChunk *chunk);
+
+    // Chunks submitted with the last frame. Thread safe.
+    size_t GetActiveChunksCount() const;
+
+private:
+    Map *map;
+
+    // Chunks to step, MapChunk::heatAwake is set for them
+    std::vector<MapChunk *> awakeChunks;
+    std::atomic<size_t> lastFrameChunks;
+    // Chunks with MapChunk::heatStateChanged
+    std::vector<MapChunk *> changedChunks;
+    // Worker reads the temperatures, so they are set when the frame is applied
+    bool stepping;
+    std::vector<std::pair<Tile *, temperature>> pendingTemperatures;
+
+    // Write the next temperatures of the chunk
+    static void conduct(MapChunk *chunk, const std::array<const MapChunk *, 4> &neighbours, float seconds);
+    void wakeNeighbours(const MapChunk *chunk);
+    // Null for untouched chunks and out of the map
+    MapChunk *findChunk(int x, int y, uint z) const;
+};
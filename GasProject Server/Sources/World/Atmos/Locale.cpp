@@ -1,5 +1,7 @@
 ﻿#include "Locale.hpp"
 
+#include <algorithm>
+
 #include <plog/Log.h>
 
 #include <World/World.hpp>
@@ -8,30 +10,50 @@
 #include "Atmos.hpp"
 
 Locale::Locale(Atmos *atmos, Tile *tile) :
-    atmos(atmos), gases(int(Gas::Count), 0),
-    closed(true)
+    atmos(atmos), mixture(atmos->allocateMixture()),
+    slot(0),
+    closed(true),
+    needToCheckCloseness(true),
+    breaches(0),
+    awake(false), awakeIndex(0),
+    lastGradient(0)
 {
-    tiles.push_back(tile);
-    tile->locale = this;
+    tile->spaceNeighbours = tile->countSpaceNeighbours();
+    pushTile(tile);
+    mix().Add(tile->gases);
+    tile->gases.Clear();
+}
+
+Locale::~Locale() {
+    atmos->releaseMixture(mixture);
 }
 
 void Locale::Update(sf::Time timeElapsed) {
     if (needToCheckCloseness) {
-        for (auto tile : tiles) {
-            for (int dx = -1; dx <= 1; dx++)
-                for (int dy = -1; dy <= 1; dy++) {
-                    Tile *neighbour = tile->GetMap()->GetTile({ tile->GetPos().x + dx, tile->GetPos().y + dy, tile->GetPos().z });
-                    if (!neighbour ||
-                        dx == 0 && dy == 0)
-                        continue;
-                    if (neighbour->IsSpace()) {
-                        closed = false;
-                        return;
-                    }
-                }
-        }
-        closed = true;
+        closed = !breaches;
+        needToCheckCloseness = false;
+        // Gas leaks in proportion to the pressure, that is to the amount per tile
+        atmos->ventRates[mixture] = tiles.empty() ? 0 : float(breaches) / float(tiles.size());
     }
+
+    sinceChange += timeElapsed;
+    // Gas moves only between the locale and space, where the pressure is 0
+    lastGradient = 0;
+    if (!closed && !tiles.empty()) {
+        const GasMixture &mixture = GetMixture();
+        for (int gas = 0; gas < GasMixture::LANES; gas++)
+            lastGradient = std::max(lastGradient, mixture.gases[gas]);
+        lastGradient /= float(tiles.size());
+    }
+}
+
+void Locale::Wake() {
+    sinceChange = sf::Time::Zero;
+    atmos->wakeLocale(this);
+}
+
+bool Locale::IsSettled() const {
+    return !needToCheckCloseness && lastGradient < Atmos::EQUILIBRIUM_GRADIENT && sinceChange >= Atmos::SETTLE_TIME;
 }
 
 void Locale::AddTile(Tile* tile) {
@@ -39,12 +61,15 @@ void Locale::AddTile(Tile* tile) {
         LOGE << "Error: try to add nullptr to Locale";
         return;
     }
-    if (tile->locale == this) {
+    if (tile->GetLocale() == this) {
         LOGW << "Warning: try to add tile to Locale twice";
         return;
     }
-    tiles.push_back(tile);
-    tile->locale = this;
+    tile->spaceNeighbours = tile->countSpaceNeighbours();
+    pushTile(tile);
+    mix().Add(tile->gases);
+    tile->gases.Clear();
+    onChanged();
 }
 
 void Locale::RemoveTile(Tile* tile) {
@@ -53,42 +78,99 @@ void Locale::RemoveTile(Tile* tile) {
         return;
     }
 
-    for (auto iter = tiles.begin(); iter != tiles.end(); iter++) {
-        if (*iter == tile) {
-            tiles.erase(iter);
-            tile->locale = nullptr;
-            return;
-        }
+    if (tile->GetLocale() != this) {
+        LOGW << "Warning: try to remove tile from Locale, but it doesn't contain it";
+        return;
     }
-    LOGW << "Warning: try to remove tile from Locale, but it doesn't contain it";
+    mix().Scale(float(tiles.size() - 1) / float(tiles.size()));
+    eraseTile(tile);
+    tile->setLocale(nullptr);
+    onChanged();
 }
 
 void Locale::Merge(Locale *locale) {
     if (locale == this) return;
+    // Tiles of a locale have no gas of their own, so they are just relabeled
     for (auto tile : locale->tiles) {
-        AddTile(tile);
+        pushTile(tile);
     }
     locale->tiles.clear();
+    mix().Add(locale->mix());
+    locale->mix().Clear();
+    onChanged();
     atmos->RemoveLocale(locale);
 }
 
+Locale *Locale::Split(const std::vector<Tile *> &part) {
+    GasMixture share = mix();
+    share.Scale(float(part.size()) / float(tiles.size()));
+    mix().Scale(float(tiles.size() - part.size()) / float(tiles.size()));
+    for (auto tile : part)
+        eraseTile(tile);
+    onChanged();
+
+    Locale *locale = atmos->CreateLocale(part.front());
+    for (size_t i = 1; i < part.size(); i++)
+        locale->pushTile(part[i]);
+    locale->mix() = share;
+    return locale;
+}
+
 void Locale::Clear() {
+    GasMixture share = mix();
+    if (!tiles.empty())
+        share.Scale(1.f / float(tiles.size()));
     for (auto tile: tiles) {
-        tile->locale = nullptr;
+        tile->setLocale(nullptr);
+        tile->gases = share;
     }
     tiles.clear();
+    mix().Clear();
+    breaches = 0;
     closed = true;
+    atmos->ventRates[mixture] = 0;
 }
 
-void Locale::Open() {
-    closed = false;
-}
-
-void Locale::CheckCloseness() {
-    needToCheckCloseness = true;
+void Locale::ChangeBreaches(Tile *tile, int delta) {
+    tile->spaceNeighbours += delta;
+    breaches += delta;
+    onChanged();
 }
 
 bool Locale::IsEmpty() const { return tiles.empty(); }
 bool Locale::IsClosed() const { return closed; }
 uint Locale::NumOfTiles() const { return uint(tiles.size()); }
 
+const GasMixture &Locale::GetMixture() const { return atmos->mixtures[mixture]; }
+
+pressure Locale::GetPressure(Gas gas) const {
+    return tiles.empty() ? 0 : GetMixture()[gas] / float(tiles.size());
+}
+
+pressure Locale::GetTotalPressure() const {
+    return tiles.empty() ? 0 : GetMixture().Total() / float(tiles.size());
+}
+
+GasMixture &Locale::mix() { return atmos->mixtures[mixture]; }
+
+void Locale::onChanged() {
+    needToCheckCloseness = true;
+    Wake();
+}
+
+void Locale::pushTile(Tile *tile) {
+    tile->setLocale(this);
+    tile->localeIndex = uint(tiles.size());
+    tiles.push_back(tile);
+    breaches += tile->spaceNeighbours;
+}
+
+void Locale::eraseTile(Tile *tile) {
+    // Order of tiles doesn't matter
+    Tile *last = tiles.back();
+    tiles[tile->localeIndex] = last;
+    last->localeIndex = tile->localeIndex;
+    tiles.pop_back();
+    breaches -= tile->spaceNeighbours;
+}
+
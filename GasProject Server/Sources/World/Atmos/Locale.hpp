@@ -1,7 +1,6 @@
 ﻿#pragma once
 
 #include <vector>
-#include <list>
 #include <SFML/System.hpp>
 
 #include <Shared/Types.hpp>
@@ -11,40 +10,81 @@
 
 class Tile;
 class Atmos;
+class WorldSnapshot;
 
+// Connected region of atmos-available tiles, a set of the disjoint-set forest of the map.
+// Tiles know their index in the locale, so adding and removing a tile is O(1).
+// Merging moves tiles of the smaller locale into the bigger one, so every tile moves O(log n) times at most.
 class Locale : public IHasRepeatableID {
 public:
+    // Gas of the tile is taken into the locale
     explicit Locale(Atmos *, Tile *);
+    ~Locale();
 
     void Update(sf::Time timeElapsed);
 
-    // Add Tile to locale
+    // Add Tile to locale, its gas is added to the mixture
     void AddTile(Tile *tile);
-    // Remove Tile from Locale
+    // Remove Tile from Locale, its share of the gas is lost
     void RemoveTile(Tile *tile);
-    // Merge with other locale
+    // Merge with other locale, gas included. Tiles of the argument are moved, so pass the smaller one.
     void Merge(Locale *locale);
-    // Remove all tiles
+    // Move the tiles into a new locale with their share of the gas. Tiles must belong to this locale.
+    Locale *Split(const std::vector<Tile *> &part);
+    // Remove all tiles, every tile keeps its share of the gas
     void Clear();
 
-    // Call if neighbour tile became space
-    void Open();
-    // Call if wall was build at near tile
-    void CheckCloseness();
+    // Call if a neighbour of the tile became space (1) or stopped being space (-1)
+    void ChangeBreaches(Tile *tile, int delta);
+
+    // Sleeping locales are skipped by the atmos. Tile changes, breaches and gas sources wake the locale.
+    void Wake();
+    bool IsAwake() const { return awake; }
+    // Gas is in equilibrium and nothing has changed for a while, so the locale may sleep
+    bool IsSettled() const;
 
     bool IsEmpty() const;
     bool IsClosed() const;
     uint NumOfTiles() const;
 
+    // Gas of all tiles of the locale, it's mixed evenly between them
+    const GasMixture &GetMixture() const;
+    // Pressures on every tile, kPa
+    pressure GetPressure(Gas gas) const;
+    pressure GetTotalPressure() const;
+
     friend Atmos;
+    friend WorldSnapshot;
 
 private:
     Atmos *atmos;
     
-    std::list<pressure> gases;
-    std::list<Tile *> tiles;
+    // Index of the mixture in the atmos
+    uint mixture;
+    // Index in the atmos list of locales
+    uint slot;
+    // In any order, Tile::localeIndex is the index of the tile here
+    std::vector<Tile *> tiles;
 
     // Status
     bool closed;
     bool needToCheckCloseness;
+    // Pairs of tiles and space next to them, gas leaks through every one.
+    // Sum of Tile::spaceNeighbours, kept up to date as tiles join and leave and their neighbours change.
+    uint breaches;
+
+    // Activity
+    bool awake;
+    // Index in the atmos list of awake locales
+    uint awakeIndex;
+    // The biggest difference of partial pressures with what the locale exchanges gas with, kPa
+    pressure lastGradient;
+    sf::Time sinceChange;
+
+    GasMixture &mix();
+    // Breaches of the tile are taken with it, count them first if the tile wasn't in a locale
+    void pushTile(Tile *tile);
+    void eraseTile(Tile *tile);
+    // Tiles were added or removed, or a neighbour has changed
+    void onChanged();
 };
@@ -12,9 +12,10 @@
 
 #include <Shared/Command.hpp>
 #include <Shared/Array.hpp>
+#include <Shared/Trace.hpp>
 
 Camera::Camera(const Tile * const tile) :
-    tile(nullptr), lasttile(nullptr), suspense(true),
+    tile(nullptr), lasttile(nullptr), seenChunksCount(0), suspense(true),
     changeFocus(false),
     unsuspensed(false), cameraMoved(false)
 {
@@ -48,12 +49,18 @@ void Camera::updateOverlay(sf::Time timeElapsed) {
 }
 
 void Camera::UpdateView(sf::Time timeElapsed) {
+    TRACE_SCOPE("Camera::UpdateView");
+
     if (unsuspensed && cameraMoved) 
         LOGE << "Logic error: camera unsuspensed and moved at one time";
 
     int updateOptions = GraphicsUpdateServerCommand::Option::EMPTY;
     auto command = std::make_unique<GraphicsUpdateServerCommand>();
 
+    // Before the shift, so blocks saved as synced are never the space the client was sent
+    if (tile && !unsuspensed)
+        findAllocatedBlocks();
+
     if (unsuspensed || cameraMoved) {
         if (unsuspensed) fullRecountVisibleBlocks(tile);
         else refreshVisibleBlocks(tile);
@@ -66,7 +73,7 @@ void Camera::UpdateView(sf::Time timeElapsed) {
     unsuspensed = cameraMoved = false;
 
     for (uint i = 0; i < visibleTilesSide*visibleTilesSide*visibleTilesHeight; i++) {
-		Tile *block = visibleBlocks[i];
+		const Tile *block = visibleBlocks[i];
 		if (block) {
 			if (blocksSync[i]) {
 				for (auto &diff : block->GetDifferences()) {
@@ -84,8 +91,11 @@ void Camera::UpdateView(sf::Time timeElapsed) {
 					case Global::DiffType::MOVE: {
 						MoveDiff *moveDiff = dynamic_cast<MoveDiff *>(diff.get());
 						if (visibleObjects.find(moveDiff->id) == visibleObjects.end()) {
+							Object *object = player->GetGame()->GetWorld()->GetObject(moveDiff->id);
+							if (!object) // deleted after moving
+								break;
 							apos to = moveDiff->lastblock->GetPos() + rpos(DirectionToVect(moveDiff->direction));
-							command->diffs.push_back(std::make_shared<AddDiff>(GGame->GetWorld()->GetObject(moveDiff->id), to.x, to.y, to.z));
+							command->diffs.push_back(std::make_shared<AddDiff>(object, to.x, to.y, to.z));
 							visibleObjects.insert(moveDiff->id);
 							break;
 						}
@@ -113,7 +123,10 @@ void Camera::UpdateView(sf::Time timeElapsed) {
 					}
 				}
 			} else {
-				command->blocksInfo.push_back(block->GetTileInfo(seeInvisibleAbility));
+				if (block == block->GetMap()->GetSpaceTile())
+					command->blocksInfo.push_back(Tile::GetSpaceTileInfo(blockPos(i)));
+				else
+					command->blocksInfo.push_back(block->GetTileInfo(seeInvisibleAbility));
 				for (auto &object: block->Content()) {
 					visibleObjects.insert(object->ID());
 				}
@@ -197,11 +210,18 @@ void Camera::fullRecountVisibleBlocks(const Tile * const tile) {
     firstBlockY = tile->GetPos().y - Global::FOV / 2 - Global::MIN_PADDING;
     firstBlockZ = tile->GetPos().z - Global::Z_FOV / 2;
 
-    // Filling our result vector by block pointers
+    // Filling our result vector by block pointers.
+    // Views are built concurrently, so the map is only read: untouched chunks aren't allocated.
+    const Map *map = tile->GetMap();
+    seenChunksCount = map->GetAllocatedChunksCount();
     for (uint z = 0; z < visibleTilesHeight; z++) {
 		for (uint y = 0; y < visibleTilesSide; y++) {
 			for (uint x = 0; x < visibleTilesSide; x++) {
-				visibleBlocks[flat_index({x,y,z})] = tile->GetMap()->GetTile({firstBlockX+x, firstBlockY+y, firstBlockZ+z});
+				apos pos(firstBlockX+x, firstBlockY+y, firstBlockZ+z);
+				const Tile *block = map->FindTile(pos);
+				if (!block && pos < map->GetSize())
+					block = map->GetSpaceTile();
+				visibleBlocks[flat_index({x,y,z})] = block;
 			}
 		}
 	}
@@ -259,6 +279,32 @@ void Camera::refreshVisibleBlocks(const Tile * const tile) {
     }
 }
 
+void Camera::findAllocatedBlocks() {
+    const Map *map = tile->GetMap();
+    size_t chunksCount = map->GetAllocatedChunksCount();
+    if (chunksCount == seenChunksCount)
+        return;
+    seenChunksCount = chunksCount;
+
+    const Tile *space = map->GetSpaceTile();
+    for (uint i = 0; i < visibleBlocks.size(); i++) {
+        if (visibleBlocks[i] != space)
+            continue;
+        if (const Tile *block = map->FindTile(blockPos(i))) {
+            visibleBlocks[i] = block;
+            // Client gets the whole tile instead of the space it knows
+            blocksSync[i] = false;
+        }
+    }
+}
+
 uint Camera::flat_index (const apos c) const {
 	return uf::flat_index(c,visibleTilesSide,visibleTilesSide);
+}
+
+apos Camera::blockPos(uint index) const {
+	uint x = index % visibleTilesSide;
+	uint y = index / visibleTilesSide % visibleTilesSide;
+	uint z = index / (visibleTilesSide * visibleTilesSide);
+	return apos(firstBlockX + x, firstBlockY + y, firstBlockZ + z);
 }
\ No newline at end of file
@@ -22,6 +22,8 @@ class Camera {
 public:
     explicit Camera(const Tile * const tile = nullptr);
 
+    // Cameras of different players may update their views concurrently.
+    // Should only read the world and change the camera itself.
     void UpdateView(sf::Time timeElapsed);
 
     void SetPlayer(Player * const player) { this->player = player; changeFocus = true; }
@@ -51,8 +53,11 @@ private:
 	int firstBlockX;
 	int firstBlockY;
 	int firstBlockZ;
-	std::vector<Tile *> visibleBlocks;
+	// Untouched chunks of the map are seen as its space tile
+	std::vector<const Tile *> visibleBlocks;
 	std::vector<bool> blocksSync;
+	// Allocated chunks of the map when visible blocks were found
+	size_t seenChunksCount;
 	std::unordered_set<uint> visibleObjects;
 
 	bool suspense;
@@ -67,6 +72,9 @@ private:
 
 	void fullRecountVisibleBlocks(const Tile * const tile);
 	void refreshVisibleBlocks(const Tile * const tile);
+	// Replace space seen in chunks allocated since the blocks were found
+	void findAllocatedBlocks();
 
 	uint flat_index (const apos c) const;
+	apos blockPos(uint index) const;
 };
\ No newline at end of file
@@ -13,5 +13,5 @@ public:
 	virtual ~ICameraOverlay() = default;
 
 	virtual bool IsShouldBeUpdated(sf::Time timeElapsed) const = 0;
-	virtual network::protocol::OverlayInfo GetOverlayInfo(Tile tile) const = 0;
+	virtual network::protocol::OverlayInfo GetOverlayInfo(const Tile &tile) const = 0;
 };
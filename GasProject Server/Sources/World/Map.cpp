@@ -1,50 +1,229 @@
 #include "Map.hpp"
 
+#include <algorithm>
+
 #include <plog/Log.h>
 
 #include "Tile.hpp"
 #include "Atmos/Atmos.hpp"
+#include "Atmos/AtmosWorker.hpp"
 #include "Shared/Global.hpp"
-#include "Shared/Array.hpp"
+#include "Shared/Trace.hpp"
+
+MapChunk::MapChunk(uint index) :
+	index(index),
+	locales(),
+	pendingUpdates(0),
+	temperatures(temperatureBuffers[0]),
+	nextTemperatures(temperatureBuffers[1]),
+	heatDelta(0),
+	heatAwake(false),
+	heatStateChanged(false)
+{
+	std::fill(std::begin(state), std::end(state), uint8_t(0));
+	std::fill(temperatures, temperatures + TILES, Heat::SPACE_TEMPERATURE);
+	std::fill(nextTemperatures, nextTemperatures + TILES, Heat::SPACE_TEMPERATURE);
+	std::fill(std::begin(heatState), std::end(heatState), uint8_t(0));
+	std::fill(std::begin(conductivities), std::end(conductivities), Heat::SPACE_CONDUCTIVITY);
+}
 
 Map::Map(const uint sizeX, const uint sizeY, const uint sizeZ) :
-	size(sizeX, sizeY, sizeZ)
+	size(sizeX, sizeY, sizeZ),
+	blocking(sizeX, sizeY, sizeZ),
+	objectsIndex(sizeX, sizeY, sizeZ),
+	holder(nullptr),
+	materializing(false)
 {
-	tiles.reserve(sizeX*sizeY*sizeZ);
-	for (uint z = 0; z < sizeZ; z++) {
-		for (uint y = 0; y < sizeY; y++) {
-			for (uint x = 0; x < sizeX; x++) {
-				tiles.push_back(std::make_unique<Tile>(this, apos(x,y,z)));
-			}
-		}
-	}
+	chunksX = (sizeX + MapChunk::SIZE - 1) / MapChunk::SIZE;
+	chunksY = (sizeY + MapChunk::SIZE - 1) / MapChunk::SIZE;
+	// Value-initialized, so all chunks are null
+	chunks.reset(new std::atomic<MapChunk *>[size_t(chunksX) * chunksY * sizeZ]());
 	LOGI << "Map is created with size: " << sizeX << "x" << sizeY << "x" << sizeZ;
 
 	atmos = std::make_unique<Atmos>(this);
+	heat = std::make_unique<Heat>(this);
+	atmosWorker = std::make_unique<AtmosWorker>();
+	spaceChunk = std::make_unique<MapChunk>(0);
+	spaceChunk->tiles.emplace_back(this, spaceChunk.get(), apos(0, 0, 0));
+}
+
+Map::Map(uptr<MapFile> &&mapFile, ObjectHolder *holder) :
+	Map(mapFile->GetSize().x, mapFile->GetSize().y, mapFile->GetSize().z)
+{
+	file = std::move(mapFile);
+	this->holder = holder;
+	materializedChunks.resize(file->GetChunksCount());
+	touchedChunks.resize(file->GetChunksCount());
+}
+
+Map::~Map() {
+	// Worker reads the chunks, the submitted frame is finished before they are freed
+	atmosWorker.reset();
 }
 
 void Map::ClearDiffs() {
-    for (auto &tile : tiles)
-        tile->ClearDiffs();
+    TRACE_SCOPE("Map::ClearDiffs");
+    for (uint index : chunksWithDiffs) {
+        MapChunk *chunk = chunks[index].load(std::memory_order_relaxed);
+        for (uint tile : chunk->changed)
+            chunk->tiles[tile].ClearDiffs();
+        chunk->changed.clear();
+    }
+    chunksWithDiffs.clear();
 }
 
 void Map::Update(sf::Time timeElapsed) {
-    for (auto &tile : tiles)
-		tile->Update(timeElapsed);
+    TRACE_SCOPE("Map::Update");
+    // Chunks are visited in the same order whichever was allocated first
+    std::sort(chunksToUpdate.begin(), chunksToUpdate.end());
+    chunksToUpdate.erase(std::unique(chunksToUpdate.begin(), chunksToUpdate.end()), chunksToUpdate.end());
+    updatingChunks.swap(chunksToUpdate);
+    chunksToUpdate.clear();
+
+    for (uint index : updatingChunks) {
+        MapChunk *chunk = chunks[index].load(std::memory_order_relaxed);
+        for (uint i = 0; i < MapChunk::TILES && chunk->pendingUpdates; i++)
+            if (chunk->state[i] & MapChunk::NEED_TO_UPDATE_LOCALE)
+                chunk->tiles[i].Update(timeElapsed);
+        // Updates could flag tiles which were already passed
+        if (chunk->pendingUpdates)
+            chunksToUpdate.push_back(index);
+    }
+
+    // Frame of the previous tick is computed while the game does everything else,
+    // so it's usually finished by now
+    if (atmosWorker->Wait()) {
+        AtmosFrame &frame = atmosWorker->GetFrame();
+        atmos->Apply(frame);
+        heat->Apply(frame);
+    }
+
     atmos->Update(timeElapsed);
+
+    AtmosFrame &frame = atmosWorker->GetFrame();
+    frame.seconds = timeElapsed.asSeconds();
+    atmos->Fill(frame);
+    heat->Fill(frame);
+    atmosWorker->Submit();
 }
 
 apos Map::GetSize() const { return size; }
 Atmos* Map::GetAtmos() const { return atmos.get(); };
+Heat *Map::GetHeat() const { return heat.get(); }
 
 Tile *Map::GetTile(apos pos) const {
-    if (pos < size)
-        return tiles[flat_index(pos)].get();
-    return nullptr;
+    if (!(pos < size))
+        return nullptr;
+    uint index = chunkIndex(pos);
+    MapChunk *chunk = chunks[index].load(std::memory_order_acquire);
+    if (!chunk)
+        chunk = allocateChunk(index);
+    return &chunk->tiles[(pos.y % MapChunk::SIZE) * MapChunk::SIZE + pos.x % MapChunk::SIZE];
+}
+
+Tile *Map::FindTile(apos pos) const {
+    if (!(pos < size))
+        return nullptr;
+    MapChunk *chunk = chunks[chunkIndex(pos)].load(std::memory_order_acquire);
+    if (!chunk)
+        return nullptr;
+    return &chunk->tiles[(pos.y % MapChunk::SIZE) * MapChunk::SIZE + pos.x % MapChunk::SIZE];
+}
+
+const Tile *Map::GetSpaceTile() const { return &spaceChunk->tiles[0]; }
+
+size_t Map::GetAllocatedChunksCount() const {
+    std::lock_guard<std::mutex> lock(chunksMutex);
+    return allocatedChunks.size();
+}
+
+uint Map::chunkIndex(apos pos) const {
+    return (pos.z * chunksY + pos.y / MapChunk::SIZE) * chunksX + pos.x / MapChunk::SIZE;
 }
 
-uint Map::flat_index(const apos c) const {
-	return uf::flat_index(c, size.x, size.y);
+void Map::onLocaleUpdateNeeded(MapChunk *chunk) {
+    if (!chunk->pendingUpdates++)
+        chunksToUpdate.push_back(chunk->index);
 }
 
-const vector< uptr<Tile>>& Map::GetTiles() const { return tiles; }
\ No newline at end of file
+void Map::onDiffAdded(MapChunk *chunk, uint tile) {
+    if (chunk->changed.empty())
+        chunksWithDiffs.push_back(chunk->index);
+    chunk->changed.push_back(uint16_t(tile));
+}
+
+MapChunk *Map::allocateChunk(uint index) const {
+    std::lock_guard<std::mutex> lock(chunksMutex);
+    // Another thread may have allocated it while we were waiting
+    MapChunk *chunk = chunks[index].load(std::memory_order_relaxed);
+    if (chunk)
+        return chunk;
+
+    uint z = index / (chunksX * chunksY);
+    uint originX = index % chunksX * MapChunk::SIZE;
+    uint originY = index / chunksX % chunksY * MapChunk::SIZE;
+
+    auto allocated = std::make_unique<MapChunk>(index);
+    // Tiles of the border chunks out of the map exist too, nobody can reach them
+    allocated->tiles.reserve(MapChunk::TILES);
+    for (uint y = 0; y < MapChunk::SIZE; y++)
+        for (uint x = 0; x < MapChunk::SIZE; x++)
+            allocated->tiles.emplace_back(const_cast<Map *>(this), allocated.get(), apos(originX + x, originY + y, z));
+
+    chunk = allocated.get();
+    allocatedChunks.push_back(std::move(allocated));
+    chunks[index].store(chunk, std::memory_order_release);
+    return chunk;
+}
+
+void Map::FindObjects(apos center, uint radius, uint kinds, std::vector<Object *> &found) const {
+	objectsIndex.QueryRadius(int(center.x), int(center.y), center.z, radius, kinds,
+		[&found](Object *object, uint, uint) { found.push_back(object); });
+}
+
+void Map::FindObjectsInRect(apos from, apos to, uint kinds, std::vector<Object *> &found) const {
+	objectsIndex.QueryRect(int(from.x), int(from.y), int(to.x), int(to.y), from.z, kinds,
+		[&found](Object *object, uint, uint) { found.push_back(object); });
+}
+
+void Map::Touch(apos pos) {
+	// Objects created by materializing don't touch neighbours, otherwise the whole map would be loaded
+	if (!file || materializing || !(pos < size))
+		return;
+	uint chunk = file->GetChunkIndex(pos);
+	if (touchedChunks[chunk])
+		return;
+	touchedChunks[chunk] = true;
+
+	TRACE_SCOPE("Map::Touch");
+	materializing = true;
+
+	// Camera of an object anywhere in the chunk sees this far
+	const int reach = Global::FOV / 2 + Global::MIN_PADDING;
+	const int chunkSize = int(file->GetChunkSize());
+	apos origin = file->GetChunkOrigin(chunk);
+	int minX = std::max(int(origin.x) - reach, 0);
+	int minY = std::max(int(origin.y) - reach, 0);
+	int minZ = std::max(int(origin.z) - Global::Z_FOV / 2, 0);
+	int maxX = std::min(int(origin.x) + chunkSize - 1 + reach, int(size.x) - 1);
+	int maxY = std::min(int(origin.y) + chunkSize - 1 + reach, int(size.y) - 1);
+	int maxZ = std::min(int(origin.z) + Global::Z_FOV / 2, int(size.z) - 1);
+
+	for (int z = minZ; z <= maxZ; z++)
+		for (int y = minY - minY % chunkSize; y <= maxY; y += chunkSize)
+			for (int x = minX - minX % chunkSize; x <= maxX; x += chunkSize) {
+				uint neighbour = file->GetChunkIndex(apos(x, y, z));
+				if (!materializedChunks[neighbour]) {
+					materializedChunks[neighbour] = true;
+					file->Materialize(neighbour, this, holder);
+				}
+			}
+
+	materializing = false;
+}
+
+const MapFile *Map::GetFile() const { return file.get(); }
+
+bool Map::IsMaterialized(uint chunk) const {
+	return !file || materializedChunks[chunk];
+}
@@ -1,31 +1,162 @@
 #pragma once
 
+#include <atomic>
+#include <list>
+#include <mutex>
 #include <vector>
 
 #include "Shared/Types.hpp"
+#include "Shared/BitGrid.hpp"
+#include "Shared/SpatialIndex.hpp"
 #include "Tile.hpp"
 #include "Atmos/Atmos.hpp"
+#include "Atmos/Heat.hpp"
+#include "MapFile.hpp"
+
+class ObjectHolder;
+class AtmosWorker;
+class WorldSnapshot;
+class Locale;
+struct Diff;
 
 using std::vector;
 using namespace uf;
 
+// Tiles of a square of one z-level.
+// State read by passes over the whole map is kept in packed arrays by tile index,
+// so the passes scan contiguous memory of chunks which have something to do.
+struct MapChunk {
+    static const uint SIZE = 16;
+    static const uint TILES = SIZE * SIZE;
+
+    // Bits of the tile state
+    enum : uint8_t {
+        FLOOR = 1,
+        FULL_BLOCKED = 2,
+        NEED_TO_UPDATE_LOCALE = 4
+    };
+
+    explicit MapChunk(uint index);
+
+    uint index;
+    uint8_t state[TILES];
+    Locale *locales[TILES];
+    std::list<sptr<Diff>> differences[TILES];
+    // Tiles with NEED_TO_UPDATE_LOCALE
+    uint pendingUpdates;
+    // Indices of tiles with differences
+    vector<uint16_t> changed;
+
+    // Heat is double buffered. The worker reads the published temperatures of the chunk and its neighbours
+    // and writes the next ones, pointers are swapped when its frame is applied.
+    temperature temperatureBuffers[2][TILES];
+    temperature *temperatures;
+    temperature *nextTemperatures;
+    // Tile state as the worker sees it, synced from state before a frame is submitted
+    uint8_t heatState[TILES];
+    float conductivities[TILES];
+    // The largest change of the last heat step, written by the worker
+    temperature heatDelta;
+    bool heatAwake;
+    bool heatStateChanged;
+
+    // Reserved for the whole chunk at once, so pointers to tiles stay valid
+    vector<Tile> tiles;
+};
+
 class Map {
 public:
+    friend WorldSnapshot;
+    friend Tile;
+    friend Heat;
+
     explicit Map(const uint sizeX, const uint sizeY, const uint sizeZ);
+    // Map of the file size. Chunks of the file are materialized by the holder when they are first touched.
+    Map(uptr<MapFile> &&file, ObjectHolder *holder);
+    ~Map();
 
     void ClearDiffs();
+    // Atmos step of the tick is computed by the worker thread and applied at the next tick
     void Update(sf::Time timeElapsed);
 
     apos GetSize() const;
     Atmos *GetAtmos() const;
+    Heat *GetHeat() const;
+    // Tiles are allocated by chunks on first access, untouched chunks are implicit empty space.
+    // Null only if the position is out of the map. Safe to call from several threads,
+    // returned tiles never move. For changing the map, readers should use FindTile.
     Tile *GetTile(apos pos) const;
-    const vector<uptr<Tile>> &GetTiles() const;
+    // Null for positions out of the map or in chunks nobody has touched yet (empty space)
+    Tile *FindTile(apos pos) const;
+    // Stands for tiles of untouched chunks where readers need a tile: space without content
+    // and diffs, it never changes. Its position means nothing.
+    const Tile *GetSpaceTile() const;
+
+    // Call callback(Tile *) for tiles of allocated chunks only. Call from the game thread only,
+    // or from the snapshot task between ticks, while the game thread waits for it in Game::waitSnapshotTaken.
+    template<class Callback>
+    void ForEachTile(Callback &&callback) const;
+    size_t GetAllocatedChunksCount() const;
+
+    // Tiles with dense objects, one bit per tile, rows of every z-level are packed into words.
+    // Kept up to date by tiles, so movement and pathfinding can test many tiles at once.
+    const uf::BitGrid &GetBlocking() const { return blocking; }
+    // True if the tile is dense or out of the map
+    bool IsBlocked(apos pos) const { return !(pos < size) || blocking.Get(pos.x, pos.y, pos.z); }
+
+    // Objects lying on tiles of the z-level (held ones aren't included) of any of the kinds, see ObjectKind.
+    // Kinds 0 match any object. Only chunks around the range are visited.
+    void FindObjects(apos center, uint radius, uint kinds, std::vector<Object *> &found) const;
+    void FindObjectsInRect(apos from, apos to, uint kinds, std::vector<Object *> &found) const;
+
+    // Materialize chunks which may be seen or reached from the position. Call from the game thread only.
+    void Touch(apos pos);
+    // Null if the map isn't loaded from a file
+    const MapFile *GetFile() const;
+    bool IsMaterialized(uint chunk) const;
 
 private:
     apos size;
 
     uptr<Atmos> atmos;
+    uptr<Heat> heat;
+    uptr<AtmosWorker> atmosWorker;
+    // Holds the space tile only, it isn't a part of the map
+    uptr<MapChunk> spaceChunk;
 
-    vector<uptr<Tile>> tiles;
-	uint flat_index(const apos c) const;
+    uint chunksX, chunksY;
+    // Chunk by index for lock-free lookup, null until the chunk is allocated
+    uptr<std::atomic<MapChunk *>[]> chunks;
+    // Owns allocated chunks in order of allocation
+    mutable vector<uptr<MapChunk>> allocatedChunks;
+    mutable std::mutex chunksMutex;
+    uint chunkIndex(apos pos) const;
+    MapChunk *allocateChunk(uint index) const;
+
+    // Indices of chunks with tiles to update or differences to clear, filled by tiles
+    vector<uint> chunksToUpdate;
+    vector<uint> updatingChunks;
+    vector<uint> chunksWithDiffs;
+    void onLocaleUpdateNeeded(MapChunk *chunk);
+    void onDiffAdded(MapChunk *chunk, uint tile);
+
+    uf::BitGrid blocking;
+    uf::SpatialIndex<Object *> objectsIndex;
+    // for use from Tile
+    void setBlocked(apos pos, bool blocked) { blocking.Set(pos.x, pos.y, pos.z, blocked); }
+
+    uptr<MapFile> file;
+    ObjectHolder *holder;
+    vector<bool> materializedChunks;
+    // Chunk's neighbourhood is materialized
+    vector<bool> touchedChunks;
+    bool materializing;
 };
+
+template<class Callback>
+void Map::ForEachTile(Callback &&callback) const {
+    // Callback may allocate new chunks, they are visited too
+    for (size_t i = 0; i < allocatedChunks.size(); i++)
+        for (auto &tile : allocatedChunks[i]->tiles)
+            callback(&tile);
+}
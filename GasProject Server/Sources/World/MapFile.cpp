@@ -0,0 +1,228 @@
+#include "MapFile.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include <plog/Log.h>
+
+#include <Shared/CRC32.h>
+
+#include "Map.hpp"
+#include "Tile.hpp"
+#include "Objects.hpp"
+#include "Objects/ObjectHolder.h"
+
+namespace {
+
+const sf::Uint32 MAP_MAGIC = "OSS-13 Map"_crc32;
+// Tile index in the chunk is 16 bit
+const uint MAX_CHUNK_SIZE = 256;
+
+const sf::Uint32 AIRLOCK_LOCKED = 1;
+
+}
+
+static_assert(sizeof(MapFile::Header) == 28, "Map file header must have no padding");
+static_assert(sizeof(MapFile::Chunk) == 8, "Map file chunk must have no padding");
+static_assert(sizeof(MapFile::Record) == 8, "Map file record must have no padding");
+
+MapFile::MapFile() :
+	header(nullptr), chunks(nullptr), records(nullptr),
+	chunksX(0), chunksY(0)
+{ }
+
+template<typename T>
+MapFile::ObjectType MapFile::objectType(std::function<void(T *, sf::Uint32)> restore, std::function<sf::Uint32(const T *)> flags) {
+	return {
+		std::type_index(typeid(::detail::Factory<T>)),
+		[restore](ObjectHolder *holder, Tile *tile, sf::Uint32 state) {
+			T *object = holder->CreateObject<T>(tile);
+			if (restore)
+				restore(object, state);
+		},
+		[flags](const Object *object) -> sf::Uint32 {
+			return flags ? flags(static_cast<const T *>(object)) : 0;
+		}
+	};
+}
+
+const std::vector<MapFile::ObjectType> &MapFile::objectTypes() {
+	// Index of the type is saved, so add new types to the end only.
+	// Records of a tile are written in this order, so floor is placed before wall.
+	static const std::vector<ObjectType> types = {
+		objectType<Floor>(),
+		objectType<Wall>(),
+		objectType<Airlock>(
+			[](Airlock *airlock, sf::Uint32 flags) { if (flags & AIRLOCK_LOCKED) airlock->Lock(); },
+			[](const Airlock *airlock) { return airlock->IsLocked() ? AIRLOCK_LOCKED : 0; }
+		),
+		objectType<Taser>(),
+		objectType<Uniform>()
+	};
+	return types;
+}
+
+uptr<MapFile> MapFile::Open(const std::string &path) {
+	uptr<MapFile> map(new MapFile());
+	if (!map->file.Open(path))
+		return nullptr;
+
+	const char *data = map->file.GetData();
+	size_t size = map->file.GetSize();
+	if (size < sizeof(Header)) {
+		LOGE << "Map file " << path << " is truncated";
+		return nullptr;
+	}
+
+	const Header *header = reinterpret_cast<const Header *>(data);
+	if (header->magic != MAP_MAGIC) {
+		LOGE << path << " is not a map file";
+		return nullptr;
+	}
+	if (header->version != VERSION) {
+		LOGE << "Map file " << path << " has unsupported version " << header->version;
+		return nullptr;
+	}
+	if (!header->sizeX || !header->sizeY || !header->sizeZ || !header->chunkSize || header->chunkSize > MAX_CHUNK_SIZE) {
+		LOGE << "Map file " << path << " has wrong size";
+		return nullptr;
+	}
+
+	map->header = header;
+	map->chunksX = (header->sizeX + header->chunkSize - 1) / header->chunkSize;
+	map->chunksY = (header->sizeY + header->chunkSize - 1) / header->chunkSize;
+	size_t chunksCount = size_t(map->chunksX) * map->chunksY * header->sizeZ;
+	if (size != sizeof(Header) + chunksCount * sizeof(Chunk) + size_t(header->recordsCount) * sizeof(Record)) {
+		LOGE << "Map file " << path << " is broken: size doesn't match the header";
+		return nullptr;
+	}
+
+	map->chunks = reinterpret_cast<const Chunk *>(data + sizeof(Header));
+	map->records = reinterpret_cast<const Record *>(map->chunks + chunksCount);
+	for (size_t i = 0; i < chunksCount; i++) {
+		const Chunk &chunk = map->chunks[i];
+		if (chunk.first > header->recordsCount || chunk.count > header->recordsCount - chunk.first) {
+			LOGE << "Map file " << path << " is broken: chunk " << i << " is out of records";
+			return nullptr;
+		}
+	}
+
+	LOGI << "Map file " << path << " is opened: " << header->sizeX << "x" << header->sizeY << "x" << header->sizeZ
+		<< ", " << chunksCount << " chunks, " << header->recordsCount << " objects";
+	return map;
+}
+
+bool MapFile::Write(const std::string &path, const Map *map) {
+	auto &types = objectTypes();
+	const MapFile *source = map->GetFile();
+	apos size = map->GetSize();
+	uint chunkSize = source ? source->GetChunkSize() : DEFAULT_CHUNK_SIZE;
+	uint chunksX = (size.x + chunkSize - 1) / chunkSize;
+	uint chunksY = (size.y + chunkSize - 1) / chunkSize;
+
+	std::vector<Chunk> chunks;
+	std::vector<Record> records;
+	chunks.reserve(size_t(chunksX) * chunksY * size.z);
+
+	for (uint z = 0; z < size.z; z++)
+		for (uint cy = 0; cy < chunksY; cy++)
+			for (uint cx = 0; cx < chunksX; cx++) {
+				Chunk chunk;
+				chunk.first = sf::Uint32(records.size());
+
+				uint index = uint(chunks.size());
+				if (source && !map->IsMaterialized(index)) {
+					const Chunk &stored = source->chunks[index];
+					records.insert(records.end(), source->records + stored.first, source->records + stored.first + stored.count);
+				} else {
+					for (uint y = 0; y < chunkSize; y++)
+						for (uint x = 0; x < chunkSize; x++) {
+							Tile *tile = map->FindTile(apos(cx * chunkSize + x, cy * chunkSize + y, z));
+							if (!tile)
+								continue;
+							for (size_t type = 0; type < types.size(); type++)
+								for (auto *object : tile->Content())
+									if (std::type_index(typeid(*object)) == types[type].type)
+										records.push_back({ sf::Uint16(y * chunkSize + x), sf::Uint16(type), types[type].flags(object) });
+						}
+				}
+
+				chunk.count = sf::Uint32(records.size()) - chunk.first;
+				chunks.push_back(chunk);
+			}
+
+	Header header;
+	header.magic = MAP_MAGIC;
+	header.version = VERSION;
+	header.sizeX = size.x;
+	header.sizeY = size.y;
+	header.sizeZ = size.z;
+	header.chunkSize = chunkSize;
+	header.recordsCount = sf::Uint32(records.size());
+
+	std::error_code error;
+	std::filesystem::path directory = std::filesystem::path(path).parent_path();
+	if (!directory.empty())
+		std::filesystem::create_directories(directory, error);
+
+	// The old file may be mapped right now, so it's replaced only when the new one is written
+	std::string tempPath = path + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char *>(chunks.data()), chunks.size() * sizeof(Chunk));
+		file.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(Record));
+		if (!file) {
+			LOGE << "Failed to write map file " << tempPath;
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempPath, path, error);
+	if (error) {
+		LOGE << "Failed to replace map file " << path << ": " << error.message();
+		return false;
+	}
+
+	LOGI << "Map file " << path << " is written: " << chunks.size() << " chunks, " << records.size() << " objects";
+	return true;
+}
+
+apos MapFile::GetSize() const {
+	return apos(header->sizeX, header->sizeY, header->sizeZ);
+}
+
+uint MapFile::GetChunkSize() const { return header->chunkSize; }
+
+uint MapFile::GetChunksCount() const { return chunksX * chunksY * header->sizeZ; }
+
+uint MapFile::GetChunkIndex(apos pos) const {
+	return (pos.z * chunksY + pos.y / header->chunkSize) * chunksX + pos.x / header->chunkSize;
+}
+
+apos MapFile::GetChunkOrigin(uint chunk) const {
+	return apos(chunk % chunksX * header->chunkSize,
+	            chunk / chunksX % chunksY * header->chunkSize,
+	            chunk / (chunksX * chunksY));
+}
+
+void MapFile::Materialize(uint chunk, Map *map, ObjectHolder *holder) const {
+	auto &types = objectTypes();
+	uint chunkSize = header->chunkSize;
+	apos origin = GetChunkOrigin(chunk);
+
+	const Chunk &info = chunks[chunk];
+	for (const Record *record = records + info.first; record != records + info.first + info.count; record++) {
+		Tile *tile = map->GetTile(apos(origin.x + record->tile % chunkSize, origin.y + record->tile / chunkSize, origin.z));
+		if (!tile || record->type >= types.size()) {
+			LOGW << "Wrong record in the chunk " << chunk << " of the map file is skipped";
+			continue;
+		}
+		types[record->type].create(holder, tile, record->flags);
+	}
+
+	// Rooms of the map are filled with air when they appear
+	Atmos *atmos = map->GetAtmos();
+	for (const Record *record = records + info.first; record != records + info.first + info.count; record++)
+		atmos->FillWithAir(map->FindTile(apos(origin.x + record->tile % chunkSize, origin.y + record->tile / chunkSize, origin.z)));
+}
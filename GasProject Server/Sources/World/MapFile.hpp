@@ -0,0 +1,88 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+#include <SFML/Config.hpp>
+
+#include <Shared/Types.hpp>
+#include <Shared/MappedFile.hpp>
+
+class Map;
+class Object;
+class ObjectHolder;
+class Tile;
+
+// Turfs and static objects of the map, split into square chunks on every z-level.
+// The file is memory-mapped and chunks are materialized by Map when they are first touched,
+// so regions nobody visits cost neither startup time nor memory.
+//
+// Layout, little-endian:
+//     Header
+//     Chunk[chunks count]     ordered by z, then y, then x
+//     Record[records count]   records of a chunk are stored together, tile by tile
+class MapFile {
+public:
+	// Increase on any change of the format
+	static const sf::Uint32 VERSION = 1;
+	static const uint DEFAULT_CHUNK_SIZE = 16;
+
+	struct Header {
+		sf::Uint32 magic;
+		sf::Uint32 version;
+		sf::Uint32 sizeX;
+		sf::Uint32 sizeY;
+		sf::Uint32 sizeZ;
+		sf::Uint32 chunkSize;
+		sf::Uint32 recordsCount;
+	};
+
+	struct Chunk {
+		sf::Uint32 first; // index of the first record
+		sf::Uint32 count;
+	};
+
+	struct Record {
+		sf::Uint16 tile;  // index of the tile in the chunk
+		sf::Uint16 type;  // index in the object types table
+		sf::Uint32 flags; // type-specific state
+	};
+
+	// Null if there is no file or it's broken
+	static uptr<MapFile> Open(const std::string &path);
+	// Save turfs and static objects of the map. Chunks the map hasn't materialized yet
+	// are copied from its own file. False if the file can't be written.
+	static bool Write(const std::string &path, const Map *map);
+
+	apos GetSize() const;
+	uint GetChunkSize() const;
+	uint GetChunksCount() const;
+	uint GetChunkIndex(apos pos) const;
+	// Position of the chunk's first tile
+	apos GetChunkOrigin(uint chunk) const;
+
+	// Create objects of the chunk on the map
+	void Materialize(uint chunk, Map *map, ObjectHolder *holder) const;
+
+private:
+	MapFile();
+
+	struct ObjectType {
+		std::type_index type;
+		std::function<void(ObjectHolder *, Tile *, sf::Uint32 flags)> create;
+		std::function<sf::Uint32(const Object *)> flags;
+	};
+
+	template<typename T>
+	static ObjectType objectType(std::function<void(T *, sf::Uint32)> restore = {}, std::function<sf::Uint32(const T *)> flags = {});
+	static const std::vector<ObjectType> &objectTypes();
+
+	uf::MappedFile file;
+	const Header *header;
+	const Chunk *chunks;
+	const Record *records;
+	uint chunksX;
+	uint chunksY;
+};
@@ -14,6 +14,8 @@ enum class ClothSlot : char {
 class Clothing : public Item
 {
 public:
+	static const uint KIND = Item::KIND | ObjectKind::Clothing;
+
 	Clothing();
 
 	ClothSlot GetSlot();
@@ -5,6 +5,8 @@
 class Uniform : public Clothing
 {
 public:
+	static const uint KIND = Clothing::KIND | ObjectKind::Uniform;
+
 	Uniform();
 
 	// Object
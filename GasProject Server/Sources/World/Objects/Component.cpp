@@ -1,9 +1,18 @@
 #include "Component.hpp"
 
+#include <atomic>
+
 Component::Component() :
-    owner(nullptr)
+    owner(nullptr),
+    typeID(0),
+    storageIndex(NOT_STORED)
 { }
 
+uint Component::newTypeID() {
+	static std::atomic<uint> count(0);
+	return count++;
+}
+
 Object *Component::GetOwner() const { return owner; }
 void Component::SetOwner(Object *owner) { this->owner = owner; }
 
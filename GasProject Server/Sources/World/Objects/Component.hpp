@@ -2,9 +2,17 @@
 
 #include <SFML/System/Time.hpp>
 
+#include <Shared/Types.hpp>
+
+#include <Shared/Network/Archive.h>
+
 class Object;
+class ObjectHolder;
 
 class Component {
+	friend Object;
+	friend ObjectHolder;
+
 protected:
 	Object *owner;
 
@@ -12,9 +20,30 @@ public:
     Component();
     virtual ~Component() = default;
 
+	// Compile-time type key: every component class gets its own dense number
+	template<class T> static uint TypeID();
+	uint GetTypeID() const { return typeID; }
+
 	virtual void Update(sf::Time timeElapsed) = 0;
+	// True if the component has work for the next tick, keeps the owner awake
+	virtual bool IsActive() const { return false; }
+	// Save or load state with the owner
+	virtual void Serialize(uf::Archive &) { }
 
 	Object *GetOwner() const;
 	virtual void SetOwner(Object *owner);
+
+private:
+	static uint newTypeID();
+
+	static const uint NOT_STORED = uint(-1);
+
+	uint typeID;
+	uint storageIndex; // index in the holder's array of active components of this type
 };
 
+template<class T> uint Component::TypeID() {
+	static const uint id = newTypeID();
+	return id;
+}
+
@@ -1,6 +1,5 @@
 #include "Control.hpp"
 
-#include <IGame.h>
 #include <World/World.hpp>
 #include <World/Map.hpp>
 #include <World/Objects/Creature.hpp>
@@ -11,8 +10,9 @@
 
 Control::Control(float speed) : 
 	speed(speed), 
-    player(nullptr), 
-    clickedObjectID(0)
+    moveZOrder(0),
+    clickedObjectID(0),
+    player(nullptr)
 {
 
 }
@@ -26,7 +26,7 @@ void Control::Update(sf::Time timeElapsed) {
     moveOrder = {};
     moveZOrder = 0;
 
-	if (auto *creature = dynamic_cast<Creature *>(owner)) {
+	if (auto *creature = owner->As<Creature>()) {
 		creature->Move(order);
 		creature->MoveZ(zOrder);
 	}
@@ -35,25 +35,39 @@ void Control::Update(sf::Time timeElapsed) {
     //// Click
     ////
     if (clickedObjectID) {
-        Object *clickedObject = GGame->GetWorld()->GetObject(clickedObjectID);
+        Object *clickedObject = owner->GetObjectHolder()->GetObject(clickedObjectID);
 
-        if (auto *creature = dynamic_cast<Creature *>(owner))
+        if (auto *creature = owner->As<Creature>())
             creature->TryInteractWith(clickedObject);
 
         clickedObjectID = 0;
     }
 }
 
+bool Control::IsActive() const {
+	return moveOrder || moveZOrder || clickedObjectID;
+}
+
+void Control::Serialize(uf::Archive &ar) {
+	ar & speed;
+	ar & moveOrder;
+	ar & moveZOrder;
+	ar & clickedObjectID;
+}
+
 void Control::MoveCommand(uf::vec2i order) {
 	moveOrder = order;
+	if (owner) owner->Wake();
 }
 
 void Control::MoveZCommand(bool order) {
 	moveZOrder = order?1:-1;
+	if (owner) owner->Wake();
 }
 
 void Control::ClickObjectCommand(uint id) {
     clickedObjectID = id;
+	if (owner) owner->Wake();
 }
 
 void Control::SetOwner(Object *owner) {
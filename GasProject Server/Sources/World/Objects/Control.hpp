@@ -14,6 +14,8 @@ public:
     explicit Control(float speed);
 
     void Update(sf::Time timeElapsed) override;
+    bool IsActive() const override;
+    void Serialize(uf::Archive &ar) override;
 
     void MoveCommand(uf::vec2i order);
     void MoveZCommand(bool order);
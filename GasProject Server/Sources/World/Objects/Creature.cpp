@@ -23,6 +23,16 @@ void Creature::Update(sf::Time timeElapsed) {
 		stun = sf::Time::Zero;
 }
 
+bool Creature::IsActive() const {
+	return Object::IsActive() || IsStunned();
+}
+
+void Creature::Serialize(uf::Archive &ar) {
+	Object::Serialize(ar);
+	ar & seeInvisibleAbility;
+	ar & stun;
+}
+
 bool Creature::InteractedBy(Object *) {
 	return true;
 }
@@ -41,14 +51,15 @@ void Creature::Move(uf::vec2i order) {
 		if (order.x) moveIntent.x = order.x;
 		if (order.y) moveIntent.y = order.y;
 
-		Tile *newTileDiag = tile->GetMap()->GetTile(tile->GetPos() + rpos(moveIntent,0));
-		Tile *newTileX = tile->GetMap()->GetTile({ tile->GetPos().x + moveIntent.x, tile->GetPos().y, tile->GetPos().z });
-		Tile *newTileY = tile->GetMap()->GetTile({ tile->GetPos().x, tile->GetPos().y + moveIntent.y, tile->GetPos().z });
-
 		if (GetDensity()) {
-			if (!newTileDiag || newTileDiag->IsDense()) moveIntent = GetMoveIntent();
-			if (!newTileX || newTileX->IsDense()) moveIntent.x = 0;
-			if (!newTileY || newTileY->IsDense()) moveIntent.y = 0;
+			Map *map = tile->GetMap();
+			apos pos = tile->GetPos();
+			bool blockedDiag = map->IsBlocked(pos + rpos(moveIntent, 0));
+			bool blockedX = map->IsBlocked({ pos.x + moveIntent.x, pos.y, pos.z });
+			bool blockedY = map->IsBlocked({ pos.x, pos.y + moveIntent.y, pos.z });
+			if (blockedDiag) moveIntent = GetMoveIntent();
+			if (blockedX) moveIntent.x = 0;
+			if (blockedY) moveIntent.y = 0;
 		}
 
 		SetMoveIntent(moveIntent);
@@ -64,6 +75,7 @@ bool Creature::TryInteractWith(Object *obj) {
 void Creature::Stun() {
 	GetTile()->AddDiff(new StunnedDiff(this, sf::seconds(3)));
 	stun = sf::seconds(3);
+	Wake();
 	LOGI << "Creature stunned" << std::endl;
 }
 
@@ -7,11 +7,15 @@
 class Clothing;
 
 class Creature : public Object {
+public:
+	static const uint KIND = Object::KIND | ObjectKind::Creature;
+
 protected:
 	Creature();
 
 public:
 	virtual void Update(sf::Time timeElapsed) override;
+	virtual bool IsActive() const override;
     bool InteractedBy(Object *) override;
 
 	virtual void Move(uf::vec2i order);
@@ -25,6 +29,9 @@ public:
 
 	bool IsStunned() const;
 
+protected:
+	virtual void Serialize(uf::Archive &ar) override;
+
 protected:
 	uint seeInvisibleAbility;
 
@@ -26,6 +26,15 @@ void Ghost::MoveZ(int order) {
 	}
 }
 
+void Ghost::Serialize(uf::Archive &ar) {
+	Creature::Serialize(ar);
+	// Control is saved as its owner
+	Object *host = hostControl ? hostControl->GetOwner() : nullptr;
+	serializeReference(ar, host);
+	if (ar.IsOutput())
+		hostControl = host ? host->GetComponent<Control>() : nullptr;
+}
+
 void Ghost::SetHostControl(Control *control) {
 	hostControl = control;
 }
@@ -5,6 +5,9 @@
 class Control;
 
 class Ghost : public Creature {
+public:
+	static const uint KIND = Creature::KIND | ObjectKind::Ghost;
+
 protected:
 	Ghost();
 
@@ -16,6 +19,9 @@ public:
 	void SetHostControl(Control *control);
 	Control *GetHostControl() const;
 
+protected:
+	virtual void Serialize(uf::Archive &ar) final;
+
 private:
 	Control *hostControl;
 };
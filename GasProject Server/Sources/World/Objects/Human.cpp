@@ -18,16 +18,16 @@ Human::Human() :
 }
 
 bool Human::InteractedBy(Object *obj) {
-	if (auto *human = dynamic_cast<Human *>(obj)) {
+	if (auto *human = obj->As<Human>()) {
 		for (auto &cloth: clothes) {
-			if (human->TakeItem(cloth.second)) {
+			if (cloth.second && human->TakeItem(cloth.second)) {
 				return true;
 			}
 		}
 		return false;
 	}
 
-	if (auto *cloth = dynamic_cast<Clothing *>(obj)) {
+	if (auto *cloth = obj->As<Clothing>()) {
 	    if (PutOn(cloth))
 	        return true;
 	    return false;
@@ -44,13 +44,12 @@ bool Human::TryInteractWith(Object *obj) {
         if (obj->InteractedBy(hands[0]))
 			return true;
 
-        if (auto *item = dynamic_cast<Item *>(hands[0]))
-            item->InteractWith(obj);
+        hands[0]->InteractWith(obj);
 
         return true;
     }
 
-	if (auto *item = dynamic_cast<Item *>(obj)) {
+	if (auto *item = obj->As<Item>()) {
 		if (TakeItem(item))
 			return true;
 	}
@@ -120,7 +119,7 @@ void Human::pushToIcons(ClothSlot slot) const {
 	}
 
 	if (item)
-		icons.push_back(GServer->GetRM()->GetIconInfo(item->GetSprite(), state));
+		icons.push_back({ item->GetSpriteIcon(), state });
 }
 
 bool Human::RemoveObject(Object *objToRemove) {
@@ -131,7 +130,7 @@ bool Human::RemoveObject(Object *objToRemove) {
 		}
 	}
 
-	if (auto *cloth = dynamic_cast<Clothing *>(objToRemove)) {
+	if (auto *cloth = objToRemove->As<Clothing>()) {
 	    Clothing *&onMob = clothes[cloth->GetSlot()];
 	    if (onMob == cloth)
 	        onMob = nullptr;
@@ -140,6 +139,31 @@ bool Human::RemoveObject(Object *objToRemove) {
 	return Object::RemoveObject(objToRemove);
 }
 
+void Human::Serialize(uf::Archive &ar) {
+	Creature::Serialize(ar);
+	for (auto *&item : hands)
+		serializeReference(ar, item);
+
+	sf::Int32 clothesCount = sf::Int32(clothes.size());
+	ar & clothesCount;
+	if (ar.IsOutput()) {
+		clothes.clear();
+		for (sf::Int32 i = 0; i < clothesCount; i++) {
+			sf::Int32 slot;
+			Clothing *cloth = nullptr;
+			ar & slot;
+			serializeReference(ar, cloth);
+			clothes[ClothSlot(slot)] = cloth;
+		}
+	} else {
+		for (auto &cloth : clothes) {
+			sf::Int32 slot = sf::Int32(cloth.first);
+			ar & slot;
+			serializeReference(ar, cloth.second);
+		}
+	}
+}
+
 void Human::updateIcons() const {
 	Object::updateIcons();
 	
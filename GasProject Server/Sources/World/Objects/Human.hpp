@@ -11,6 +11,9 @@ enum class ClothSlot : char;
 typedef std::unordered_map<ClothSlot, Clothing *> ClothSlots;
 
 class Human : public Creature {
+public:
+	static const uint KIND = Creature::KIND | ObjectKind::Human;
+
 protected:
 	Human();
 public:
@@ -27,6 +30,7 @@ public:
 
 protected:
 	virtual void updateIcons() const override;
+	virtual void Serialize(uf::Archive &ar) override;
 
 private:
 	void pushToIcons(ClothSlot) const; // TODO: detail
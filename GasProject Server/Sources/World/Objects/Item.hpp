@@ -4,6 +4,8 @@
 
 class Item : public Object {
 public:
+	static const uint KIND = Object::KIND | ObjectKind::Item;
+
     Item() {
         layer = 50;
         density = false;
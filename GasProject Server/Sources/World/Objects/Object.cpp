@@ -5,6 +5,9 @@
 #include <Network/Differences.hpp>
 #include <World/World.hpp>
 #include <World/Map.hpp>
+#include <World/Objects/ObjectHolder.h>
+
+#include <plog/Log.h>
 
 #include <Shared/TileGrid_Info.hpp>
 #include <Shared/Math.hpp>
@@ -12,14 +15,21 @@
 
 Object::Object() :
     density(false), 
+    airtight(false),
     movable(true),
 	spriteState(Global::ItemSpriteState::DEFAULT),
     layer(0), 
     direction(uf::Direction::NONE), 
     invisibility(0),
+    id(0),
+    kind(0),
+    objectHolder(nullptr),
+    awake(false),
     tile(nullptr),
 	holder(nullptr),
-    moveSpeed(0)
+    moveSpeed(0),
+    iconsOutdated(false),
+    spriteIcon(0)
 { }
 
 void Object::AfterCreation() { 
@@ -27,9 +37,7 @@ void Object::AfterCreation() {
 }
 
 void Object::Update(sf::Time timeElapsed) {
-    for (auto &component : components) {
-        component->Update(timeElapsed);
-    }
+    // Components are updated by the holder in batches by type, before objects
 
     uf::vec2f deltaShift = uf::phys::countDeltaShift(timeElapsed, shift, moveSpeed, moveIntent, constSpeed, physSpeed);
     shift += deltaShift;
@@ -69,6 +77,24 @@ void Object::Update(sf::Time timeElapsed) {
 	animationTimer.Update(timeElapsed);
 }
 
+bool Object::IsActive() const {
+    if (moveIntent || constSpeed || physSpeed || shift)
+        return true;
+    if (iconsOutdated || animationTimer.NeedsUpdate())
+        return true;
+    for (auto &component : components)
+        if (component->IsActive())
+            return true;
+    return false;
+}
+
+void Object::Wake() {
+    if (awake || !id || !objectHolder)
+        return;
+    awake = true;
+    objectHolder->wakeObject(this);
+}
+
 void Object::AddObject(Object *obj) {
 	if (!obj) return;
 
@@ -97,18 +123,38 @@ bool Object::RemoveObject(Object *obj) {
     return false;
 }
 
-void Object::AddComponent(Component *new_component) {
-	if (!new_component) return;
-    new_component->SetOwner(this);
-    components.push_back(uptr<Component>(new_component));
+void Object::addComponent(Component *component) {
+	uint typeID = component->typeID;
+	if (typeID < componentsByType.size() && componentsByType[typeID]) {
+		LOGE << "Object " << name << " has the component of this type already";
+		delete component;
+		return;
+	}
+	if (typeID >= componentsByType.size())
+		componentsByType.resize(typeID + 1);
+	componentsByType[typeID] = component;
+	component->SetOwner(this);
+	components.push_back(uptr<Component>(component));
+	// Components of objects being created join the holder when the object is woken
+	if (objectHolder)
+		objectHolder->addComponent(component);
 }
 
 void Object::SetConstSpeed(uf::vec2f speed) {
     constSpeed = speed;
+    if (constSpeed)
+        Wake();
 }
 
 void Object::SetSprite(const std::string &sprite) {
     this->sprite = sprite;
+    spriteIcon = 0;
+	askToUpdateIcons();
+}
+
+void Object::SetSprite(IconID sprite) {
+    this->sprite = GServer->GetRM()->GetIconInfo(sprite).title;
+    spriteIcon = sprite;
 	askToUpdateIcons();
 }
 
@@ -117,31 +163,73 @@ void Object::SetSpriteState(Global::ItemSpriteState newState) {
 }
 
 bool Object::PlayAnimation(const std::string &animation, std::function<void()> &&callback) {
+	return PlayAnimation(GServer->GetRM()->GetIconID(animation), std::move(callback));
+}
+
+bool Object::PlayAnimation(IconID animation, std::function<void()> &&callback) {
 	if (!animationTimer.IsStopped())
 		return false;
 
-	auto iconInfo = GServer->GetRM()->GetIconInfo(animation);
+	const IconInfo &iconInfo = GServer->GetRM()->GetIconInfo(animation);
 
-    GetTile()->AddDiff(new PlayAnimationDiff(this, iconInfo.id));
+    GetTile()->AddDiff(new PlayAnimationDiff(this, animation));
 
 	animationTimer.Start(iconInfo.animation_time, std::forward<std::function<void()>>(callback));
+	if (animationTimer.NeedsUpdate())
+		Wake();
 	return true;
 }
 
 void Object::Delete() {
-    if (tile) tile->RemoveObject(this);
+    if (!id)
+        return;
+    // Content is freed together with its holder
+    auto contained = content;
+    for (auto *obj : contained)
+        obj->Delete();
+    if (holder) holder->RemoveObject(this);
+    else if (tile) tile->RemoveObject(this);
+    animationTimer.Stop();
+    if (objectHolder)
+        objectHolder->deleteObject(this);
     id = 0;
 }
 
 uint Object::ID() const { return id; }
+ObjectHolder *Object::GetObjectHolder() const { return objectHolder; }
 std::string Object::GetName() const { return name; }
 Tile *Object::GetTile() const { return tile; }
 Object *Object::GetHolder() const { return holder; }
 
 bool Object::GetDensity() const { return density; };
+void Object::SetDensity(bool density) {
+    if (this->density == density)
+        return;
+    this->density = density;
+    // Held objects aren't in the tile content
+    if (tile && !holder)
+        tile->changeDensity(density ? 1 : -1);
+}
+bool Object::IsAirtight() const { return airtight; }
+void Object::SetAirtight(bool airtight) {
+    if (this->airtight == airtight)
+        return;
+    this->airtight = airtight;
+    if (tile && !holder)
+        tile->changeAirtightness(airtight ? 1 : -1);
+}
 bool Object::IsMovable() const { return movable; };
 bool Object::IsCloseTo(Object *other) const {
-    auto pos = GetTile()->GetPos();
+    // Held objects are where their holders are
+    const Object *self = this;
+    while (!self->GetTile() && self->GetHolder())
+        self = self->GetHolder();
+    while (!other->GetTile() && other->GetHolder())
+        other = other->GetHolder();
+    if (!self->GetTile() || !other->GetTile())
+        return false;
+
+    auto pos = self->GetTile()->GetPos();
     auto otherPos = other->GetTile()->GetPos();
     if (uf::length(pos - otherPos) < 2)
         return true;
@@ -154,6 +242,12 @@ bool Object::CheckVisibility(uint visibility) const {
 }
 
 std::string Object::GetSprite() const { return sprite; }
+
+IconID Object::GetSpriteIcon() const {
+	if (!spriteIcon)
+		spriteIcon = GServer->GetRM()->GetIconID(sprite);
+	return spriteIcon;
+}
 uint Object::GetLayer() const { return layer; }
 
 
@@ -163,6 +257,8 @@ void Object::SetMoveIntent(uf::vec2i moveIntent) {
     }
     if (moveIntent.x) this->moveIntent.x = moveIntent.x;
     if (moveIntent.y) this->moveIntent.y = moveIntent.y;
+    if (this->moveIntent)
+        Wake();
 }
 
 uf::vec2i Object::GetMoveIntent() const {
@@ -207,19 +303,90 @@ ObjectInfo Object::GetObjectInfo() const {
     objectInfo.constSpeed = constSpeed;
     objectInfo.moveSpeed = moveSpeed;
 
-	for (auto &iconInfo : icons)
-		objectInfo.spriteIds.push_back(iconInfo.id + static_cast<uint32_t>(iconInfo.state));
+	for (auto &icon : icons)
+		objectInfo.spriteIds.push_back(icon.id + static_cast<uint32_t>(icon.state));
 
     return objectInfo;
 }
 
 void Object::updateIcons() const {
 	icons.clear();
-	icons.push_back(GServer->GetRM()->GetIconInfo(sprite));
+	icons.push_back({ GetSpriteIcon(), Global::ItemSpriteState::DEFAULT });
 }
 
 void Object::askToUpdateIcons() {
 	iconsOutdated = true;
+	Wake();
+}
+
+void Object::bindTimers(uf::TimerWheel *timers) {
+	animationTimer.Bind(timers);
+}
+
+void Object::Serialize(uf::Archive &ar) {
+	ar & name;
+	ar & density;
+	ar & movable;
+	ar & sprite;
+	if (ar.IsOutput())
+		spriteIcon = 0;
+	sf::Int32 state = sf::Int32(spriteState);
+	ar & state;
+	spriteState = Global::ItemSpriteState(state);
+	ar & layer;
+	ar & direction;
+	ar & invisibility;
+
+	ar & moveSpeed;
+	ar & moveIntent;
+	ar & constSpeed;
+	ar & physSpeed;
+	ar & shift;
+
+	sf::Int32 contentSize = sf::Int32(content.size());
+	ar & contentSize;
+	if (ar.IsOutput()) {
+		content.clear();
+		for (sf::Int32 i = 0; i < contentSize; i++) {
+			Object *obj = nullptr;
+			serializeReference(ar, obj);
+			if (!obj || obj->holder)
+				throw std::exception(); // "Snapshot content is broken"
+			content.push_back(obj);
+			obj->holder = this;
+		}
+	} else {
+		for (auto *obj : content)
+			serializeReference(ar, obj);
+	}
+
+	sf::Int32 componentsCount = sf::Int32(components.size());
+	ar & componentsCount;
+	if (componentsCount != sf::Int32(components.size()))
+		throw std::exception(); // "Snapshot components don't match the object"
+	for (auto &component : components)
+		component->Serialize(ar);
+}
+
+void Object::serializeReference(uf::Archive &ar, Tile *&tile) {
+	bool exists = tile != nullptr;
+	ar & exists;
+	sf::Uint32 x = 0, y = 0, z = 0;
+	if (exists) {
+		x = tile->GetPos().x;
+		y = tile->GetPos().y;
+		z = tile->GetPos().z;
+	}
+	ar & x & y & z;
+	if (ar.IsOutput()) {
+		tile = exists ? objectHolder->GetMap()->GetTile(apos(x, y, z)) : nullptr;
+		if (exists && !tile)
+			throw std::exception(); // "Snapshot references tile out of the map"
+	}
+}
+
+Object *Object::getObject(uint id) const {
+	return objectHolder ? objectHolder->GetObject(id) : nullptr;
 }
 
 void Object::setTile(Tile *newTile) {
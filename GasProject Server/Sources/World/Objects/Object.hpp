@@ -9,44 +9,94 @@
 
 #include <Shared/Types.hpp>
 #include <Shared/Global.hpp>
+#include <Shared/SmallVector.hpp>
 #include <Shared/Timer.h>
+#include <Shared/Network/Archive.h>
 
 class ObjectHolder;
 class Tile;
+class WorldSnapshot;
 struct ObjectInfo;
 
+// Bits of object classes. Every class adds its own bit to the parent's KIND,
+// so checking the class of an object is a single AND instead of dynamic_cast.
+namespace ObjectKind {
+	enum : uint {
+		Turf       = 1 << 0,
+		Floor      = 1 << 1,
+		Wall       = 1 << 2,
+		Airlock    = 1 << 3,
+		Item       = 1 << 4,
+		Taser      = 1 << 5,
+		Clothing   = 1 << 6,
+		Uniform    = 1 << 7,
+		Creature   = 1 << 8,
+		Human      = 1 << 9,
+		Ghost      = 1 << 10,
+		Projectile = 1 << 11
+	};
+}
+
 class Object {
 	friend ObjectHolder;
 	friend Tile;
+	friend WorldSnapshot;
 
 protected:
 	Object(); // Use ObjectHolder to create objects!
 
 public:
+	// Classes derived from Object declare their own KIND, see ObjectKind
+	static const uint KIND = 0;
+
     virtual ~Object() = default;
 
 	virtual void AfterCreation();
     virtual void Update(sf::Time timeElapsed);
 
+    // True if the object has something to do in the next ticks.
+    // Idle objects are not updated until woken.
+    virtual bool IsActive() const;
+    // Put the object into the active set. It's updated since the next tick.
+    void Wake();
+
     virtual bool InteractedBy(Object *) = 0;
 
 	void AddObject(Object *);
 	virtual bool RemoveObject(Object *);
-    void AddComponent(Component *);
+    // Component is owned by the object, one per type
+    template<class T> void AddComponent(T *);
     void SetConstSpeed(uf::vec2f speed);
     void SetSprite(const std::string &sprite);
+    void SetSprite(IconID sprite);
 	void SetSpriteState(Global::ItemSpriteState);
 	// False if another animation is playing already. Callback will be called after animation
 	bool PlayAnimation(const std::string &sprite, std::function<void()> &&callback = {});
+	bool PlayAnimation(IconID animation, std::function<void()> &&callback = {});
     void Delete();
 
     uint ID() const;
+    // World the object belongs to
+    ObjectHolder *GetObjectHolder() const;
     std::string GetName() const;
     Tile *GetTile() const;
 	Object *GetHolder() const;
+    // Component of exactly this type, no dynamic_cast
     template<class T> T *GetComponent();
 
+    // True if the object is of any of the kinds
+    bool Is(uint kinds) const { return kind & kinds; }
+    uint GetKind() const { return kind; }
+    // Null if the object isn't T. Uses kind bits instead of RTTI.
+    template<class T> T *As() { return (kind & T::KIND) == T::KIND ? static_cast<T *>(this) : nullptr; }
+    template<class T> const T *As() const { return (kind & T::KIND) == T::KIND ? static_cast<const T *>(this) : nullptr; }
+
     bool GetDensity() const;
+    // Tile the object lies on is notified, so its density stays up to date
+    void SetDensity(bool density);
+    // Airtight objects seal their tile for gas like walls
+    bool IsAirtight() const;
+    void SetAirtight(bool airtight);
     bool IsMovable() const;
     bool IsCloseTo(Object *) const;
     // True if visibility bits allows to see invisibility bits
@@ -55,6 +105,8 @@ public:
     uint GetInvisibility() const;
 
 	std::string GetSprite() const;
+	// Sprite name is resolved on the first call after it's changed
+	IconID GetSpriteIcon() const;
 
     uint GetLayer() const;
 
@@ -83,13 +135,28 @@ protected:
 	virtual void updateIcons() const;
 	void askToUpdateIcons();
 
+	// Bind object's timers to the wheel, so they don't need updates.
+	// Called by ObjectHolder before AfterCreation and snapshot loading.
+	virtual void bindTimers(uf::TimerWheel *timers);
+
+	// Save or load state for WorldSnapshot. Loading is called when all objects are created,
+	// so references can be resolved by ID. Tile is restored by the snapshot.
+	virtual void Serialize(uf::Archive &ar);
+	// References are saved as ID or position
+	template<class T> void serializeReference(uf::Archive &ar, T *&object);
+	void serializeReference(uf::Archive &ar, Tile *&tile);
+
 private:
 	// for use from Tile
 	void setTile(Tile *);
 
+	void addComponent(Component *);
+	Object *getObject(uint id) const;
+
 protected:
     std::string name;
     bool density;
+    bool airtight;
     bool movable;
     std::string sprite;
 	Global::ItemSpriteState spriteState; // TODO: move it to Item? Also there is need to reimplement packing???
@@ -104,14 +171,18 @@ protected:
     uint invisibility;
     //
 
-	mutable std::vector<IconInfo> icons;
+	mutable Icons icons;
 
 private:
     uint id;
+    uint kind; // set by ObjectHolder from KIND of the created class
+    ObjectHolder *objectHolder;
+    bool awake;
     Tile *tile;
 	Object *holder;
-	std::list<Object *> content;
-    std::list<uptr<Component>> components;
+	uf::SmallVector<Object *, 4> content;
+    std::vector<uptr<Component>> components; // in order of adding, so snapshots don't depend on type IDs
+    std::vector<Component *> componentsByType; // indexed by type ID, null if there is no such component
 
     // Movement
     float moveSpeed;
@@ -122,12 +193,29 @@ private:
     uf::vec2f shift;
 
 	bool iconsOutdated;
+	mutable IconID spriteIcon; // 0 until resolved
 };
 
-template <class T> T *Object::GetComponent() {
-	for (auto &component : components) {
-		if (auto temp = dynamic_cast<T *>(component.get()))
-			return temp;
+template<class T> void Object::serializeReference(uf::Archive &ar, T *&object) {
+	sf::Uint32 id = object ? object->ID() : 0;
+	ar & id;
+	if (ar.IsOutput()) {
+		object = id ? dynamic_cast<T *>(getObject(id)) : nullptr;
+		if (id && !object)
+			throw std::exception(); // "Snapshot references wrong object"
 	}
-	return nullptr;
+}
+
+template <class T> T *Object::GetComponent() {
+	uint typeID = Component::TypeID<T>();
+	if (typeID >= componentsByType.size())
+		return nullptr;
+	return static_cast<T *>(componentsByType[typeID]);
+}
+
+template<class T> void Object::AddComponent(T *component) {
+	if (!component)
+		return;
+	component->typeID = Component::TypeID<T>();
+	addComponent(component);
 }
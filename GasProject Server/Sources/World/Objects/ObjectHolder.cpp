@@ -1,20 +1,175 @@
 #include "ObjectHolder.h"
 
-#include <IGame.h>
-#include <World/World.hpp>
+#include <algorithm>
+#include <atomic>
+
+#include <Shared/ErrorHandling.h>
+#include <Shared/Trace.hpp>
+
 #include <World/Map.hpp>
 #include <World/Tile.hpp>
 
-uint32_t ObjectHolder::addObject(Object *obj) {
-	if (free_ids.empty()) {
-		objects.push_back(uptr<Object>(obj));
-		return uint32_t(objects.size());
+ObjectHolder::ObjectHolder() :
+	activeObjectsCount(0),
+	objectsCount(0),
+	reclaimedObjectsCount(0)
+{ }
+
+ObjectHolder::~ObjectHolder() {
+	for (auto &slot : objects)
+		if (slot.object) {
+			slot.object->~Object();
+			slot.slab->Free(slot.object);
+		}
+}
+
+uint ObjectHolder::GetActiveObjectsCount() const { return activeObjectsCount; }
+uint ObjectHolder::GetObjectsCount() const { return objectsCount; }
+uint64_t ObjectHolder::GetReclaimedObjectsCount() const { return reclaimedObjectsCount; }
+
+Object *ObjectHolder::GetObject(uint id) const {
+	uint index = id & ID_INDEX_MASK;
+	if (!index || index > objects.size())
+		return nullptr;
+	const ObjectSlot &slot = objects[index - 1];
+	// The slot may be free or reused by another object since the id was taken
+	if (!slot.object || slot.generation != id >> ID_INDEX_BITS || !slot.object->ID())
+		return nullptr;
+	return slot.object;
+}
+
+Map *ObjectHolder::GetMap() const { return nullptr; }
+
+uf::TimerWheel *ObjectHolder::GetTimers() { return nullptr; }
+
+void ObjectHolder::ReclaimDeletedObjects() {
+	if (deletedIds.empty())
+		return;
+	TRACE_SCOPE("ObjectHolder::Reclaim");
+
+	auto isDeleted = [](Object *obj) { return !obj->ID(); };
+	activeObjects.erase(std::remove_if(activeObjects.begin(), activeObjects.end(), isDeleted), activeObjects.end());
+	wokenObjects.erase(std::remove_if(wokenObjects.begin(), wokenObjects.end(), isDeleted), wokenObjects.end());
+
+	for (uint id : deletedIds) {
+		uint index = (id & ID_INDEX_MASK) - 1;
+		ObjectSlot &slot = objects[index];
+		deactivateComponents(slot.object);
+		slot.object->~Object();
+		slot.slab->Free(slot.object);
+		slot.object = nullptr;
+		slot.slab = nullptr;
+		slot.generation = (slot.generation + 1) & ID_GENERATION_MASK;
+		freeSlots.push_back(index);
+	}
+	reclaimedObjectsCount += deletedIds.size();
+	objectsCount = uint(objects.size() - freeSlots.size());
+	deletedIds.clear();
+}
+
+void ObjectHolder::updateObjects(sf::Time timeElapsed) {
+	activeObjects.insert(activeObjects.end(), wokenObjects.begin(), wokenObjects.end());
+	wokenObjects.clear();
+
+	updateComponents(timeElapsed);
+
+	size_t kept = 0;
+	for (size_t i = 0; i < activeObjects.size(); i++) {
+		Object *obj = activeObjects[i];
+		if (obj->ID()) {
+			obj->Update(timeElapsed);
+			if (obj->ID() && obj->IsActive()) {
+				activeObjects[kept++] = obj;
+				continue;
+			}
+		}
+		// Since now Wake() puts it to woken objects
+		obj->awake = false;
+		deactivateComponents(obj);
+	}
+	activeObjects.resize(kept);
+
+	activeObjectsCount = uint(kept);
+	objectsCount = uint(objects.size() - freeSlots.size());
+}
+
+void ObjectHolder::wakeObject(Object *obj) {
+	wokenObjects.push_back(obj);
+	activateComponents(obj);
+}
+
+void ObjectHolder::deleteObject(Object *obj) {
+	deletedIds.push_back(obj->ID());
+}
+
+void ObjectHolder::addComponent(Component *component) {
+	if (component->GetOwner()->awake)
+		activateComponent(component);
+}
+
+void ObjectHolder::activateComponent(Component *component) {
+	uint type = component->GetTypeID();
+	if (type >= activeComponents.size())
+		activeComponents.resize(type + 1);
+	component->storageIndex = uint(activeComponents[type].size());
+	activeComponents[type].push_back(component);
+}
+
+void ObjectHolder::deactivateComponent(Component *component) {
+	if (component->storageIndex == Component::NOT_STORED)
+		return;
+	auto &array = activeComponents[component->GetTypeID()];
+	Component *last = array.back();
+	array[component->storageIndex] = last;
+	last->storageIndex = component->storageIndex;
+	array.pop_back();
+	component->storageIndex = Component::NOT_STORED;
+}
+
+void ObjectHolder::activateComponents(Object *obj) {
+	for (auto &component : obj->components)
+		activateComponent(component.get());
+}
+
+void ObjectHolder::deactivateComponents(Object *obj) {
+	for (auto &component : obj->components)
+		deactivateComponent(component.get());
+}
+
+void ObjectHolder::updateComponents(sf::Time timeElapsed) {
+	TRACE_SCOPE("ObjectHolder::UpdateComponents");
+	// Objects woken during the pass join the arrays and may be updated in it too
+	for (size_t type = 0; type < activeComponents.size(); type++)
+		for (size_t i = 0; i < activeComponents[type].size(); i++) {
+			Component *component = activeComponents[type][i];
+			// Deleted objects leave the arrays when they are reclaimed
+			if (component->GetOwner()->ID())
+				component->Update(timeElapsed);
+		}
+}
+
+uint32_t ObjectHolder::addObject(Object *obj, uf::SlabAllocator *slab) {
+	uint index;
+	if (freeSlots.empty()) {
+		EXPECT_WITH_MSG((objects.size() < ID_INDEX_MASK), "Too many objects");
+		index = uint(objects.size());
+		objects.push_back({ obj, slab, 0 });
 	} else {
-		auto id = free_ids.back();
-		free_ids.pop_back();
-		objects[id - 1] = uptr<Object>(obj);
-		return id;
+		index = freeSlots.back();
+		freeSlots.pop_back();
+		objects[index].object = obj;
+		objects[index].slab = slab;
 	}
+	return makeID(index, objects[index].generation);
+}
+
+uint32_t ObjectHolder::makeID(uint slot, uint generation) {
+	return (generation << ID_INDEX_BITS) | (slot + 1);
+}
+
+uint ObjectHolder::newSlabIndex() {
+	static std::atomic<uint> count(0);
+	return count++;
 }
 
 void ObjectHolder::placeTo(Object *obj, Tile *tile) {
@@ -23,5 +178,6 @@ void ObjectHolder::placeTo(Object *obj, Tile *tile) {
 }
 
 Tile *ObjectHolder::getTile(apos coords) {
-	return GGame->GetWorld()->GetMap()->GetTile(coords);
+	Map *map = GetMap();
+	return map ? map->GetTile(coords) : nullptr;
 }
@@ -1,14 +1,32 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 
+#include <SFML/System/Time.hpp>
+
 #include <Shared/Types.hpp>
+#include <Shared/SlabAllocator.hpp>
+#include <Shared/TimerWheel.hpp>
 
 #include "Object.hpp"
 
+class Map;
+class WorldSnapshot;
+
 class ObjectHolder {
+	friend Object;
+	friend WorldSnapshot;
+
 public:
-	virtual ~ObjectHolder() = default;
+	// Object ID keeps the slot index + 1 in the low bits and the slot generation in the high ones.
+	// Generation is increased when the slot is freed, so IDs of deleted objects don't resolve to new ones.
+	static const uint ID_INDEX_BITS = 20;
+	static const uint ID_INDEX_MASK = (1u << ID_INDEX_BITS) - 1;
+	static const uint ID_GENERATION_MASK = (1u << (32 - ID_INDEX_BITS)) - 1;
+
+	ObjectHolder();
+	virtual ~ObjectHolder();
 
 	template<typename T, typename... TArgs>
 	T *CreateObject(Tile *tile = nullptr, TArgs&&... Args);
@@ -16,14 +34,80 @@ public:
 	template<typename T, typename... TArgs>
 	T *CreateObject(apos tile, TArgs&&... Args);
 
+	// Null if there is no object with the id or it's deleted. O(1).
+	Object *GetObject(uint id) const;
+	virtual Map *GetMap() const;
+
+	// Thread safe. Counted on the last update.
+	uint GetActiveObjectsCount() const;
+	uint GetObjectsCount() const;
+	// Thread safe. Total since the start.
+	uint64_t GetReclaimedObjectsCount() const;
+
+	// Destroy objects deleted since the last call and free their slots.
+	// Call it only when nobody reads the world: after the tick and all its cameras.
+	void ReclaimDeletedObjects();
+
+	// Wheel firing objects' timers. Null means timers are updated by objects.
+	virtual uf::TimerWheel *GetTimers();
+
+protected:
+	// Update the active set only. Objects which became idle leave it,
+	// objects woken during the update join it on the next one.
+	// Components of awake objects are updated first, type after type.
+	void updateObjects(sf::Time timeElapsed);
+
 private:
-	uint32_t addObject(Object *);
+	// Create object in the slot without placing and AfterCreation. For use from WorldSnapshot.
+	template<typename T, typename... TArgs>
+	T *restoreObject(uint id, TArgs&&... Args);
+
+	// Objects of every type are allocated from their own slab
+	template<typename T, typename... TArgs>
+	Object *allocateObject(uf::SlabAllocator *&slab, TArgs&&... Args);
+	template<typename T>
+	static uint slabIndex();
+	static uint newSlabIndex();
+
+	uint32_t addObject(Object *, uf::SlabAllocator *);
+	static uint32_t makeID(uint slot, uint generation);
 	void placeTo(Object *, Tile *);
 	Tile *getTile(apos);
 
+	// for use from Object
+	void wakeObject(Object *);
+	void deleteObject(Object *);
+	void addComponent(Component *);
+
+	// Components are stored while their owner is awake
+	void activateComponent(Component *);
+	void deactivateComponent(Component *);
+	void activateComponents(Object *);
+	void deactivateComponents(Object *);
+	void updateComponents(sf::Time timeElapsed);
+
+	struct ObjectSlot {
+		Object *object; // null if the slot is free
+		uf::SlabAllocator *slab;
+		uint generation;
+	};
+
 protected: // TODO: make it private!
-	std::vector<uptr<Object>> objects;
-	std::vector<uint> free_ids;
+	std::vector<ObjectSlot> objects;
+	std::vector<uint> freeSlots;
+
+private:
+	std::vector<uptr<uf::SlabAllocator>> slabs;
+	// Dense arrays of awake objects' components indexed by component type ID
+	std::vector<std::vector<Component *>> activeComponents;
+
+	std::vector<Object *> activeObjects;
+	std::vector<Object *> wokenObjects;
+	std::vector<uint> deletedIds; // reclaimed by ReclaimDeletedObjects
+
+	std::atomic<uint> activeObjectsCount;
+	std::atomic<uint> objectsCount;
+	std::atomic<uint64_t> reclaimedObjectsCount;
 };
 
 namespace detail {
@@ -44,15 +128,45 @@ protected:
 
 }
 
+template<typename T, typename... TArgs>
+Object *ObjectHolder::allocateObject(uf::SlabAllocator *&slab, TArgs&&... Args) {
+	uint index = slabIndex<T>();
+	if (index >= slabs.size())
+		slabs.resize(index + 1);
+	if (!slabs[index])
+		slabs[index] = std::make_unique<uf::SlabAllocator>(sizeof(::detail::Factory<T>), alignof(::detail::Factory<T>));
+	slab = slabs[index].get();
+
+	void *memory = slab->Allocate();
+	try {
+		auto *factory = new (memory) ::detail::Factory<T>(std::forward<TArgs>(Args)...);
+		return factory->GetObject(); // Object * is important! It's check for correct type.
+	} catch (...) {
+		slab->Free(memory);
+		throw;
+	}
+}
+
+template<typename T>
+uint ObjectHolder::slabIndex() {
+	static const uint index = newSlabIndex();
+	return index;
+}
+
 template<typename T, typename... TArgs>
 T *ObjectHolder::CreateObject(Tile *tile, TArgs&&... Args) {
-	auto *factory = new detail::Factory<T>(std::forward<TArgs>(Args)...);
-	Object *obj = factory->GetObject(); // Object * is important! It's check for correct type.
+	uf::SlabAllocator *slab;
+	Object *obj = allocateObject<T>(slab, std::forward<TArgs>(Args)...);
 
-	obj->id = addObject(obj);
+	obj->id = addObject(obj, slab);
+	obj->kind = T::KIND;
+	obj->objectHolder = this;
+	obj->bindTimers(GetTimers());
 	placeTo(obj, tile);
 
 	obj->AfterCreation();
+	// Every object gets at least one update
+	obj->Wake();
 	return static_cast<T *>(obj);
 }
 
@@ -60,3 +174,19 @@ template<typename T, typename... TArgs>
 T *ObjectHolder::CreateObject(apos coords, TArgs&&... Args) {
 	return CreateObject<T>(getTile(coords), std::forward<TArgs>(Args)...);
 }
+
+template<typename T, typename... TArgs>
+T *ObjectHolder::restoreObject(uint id, TArgs&&... Args) {
+	uf::SlabAllocator *slab;
+	Object *obj = allocateObject<T>(slab, std::forward<TArgs>(Args)...);
+
+	obj->id = id;
+	obj->kind = T::KIND;
+	obj->objectHolder = this;
+	obj->bindTimers(GetTimers());
+	ObjectSlot &slot = objects[(id & ID_INDEX_MASK) - 1];
+	slot.object = obj;
+	slot.slab = slab;
+	slot.generation = id >> ID_INDEX_BITS;
+	return static_cast<T *>(obj);
+}
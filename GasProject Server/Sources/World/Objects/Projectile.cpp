@@ -33,7 +33,12 @@ void Projectile::Update(sf::Time timeElapsed) {
     }
 }
 
+void Projectile::Serialize(uf::Archive &ar) {
+	Object::Serialize(ar);
+	serializeReference(ar, startTile);
+}
+
 void Projectile::onHit(Object *obj) {
-    if (auto *creature = dynamic_cast<Creature *>(obj))
+    if (auto *creature = obj->As<Creature>())
         creature->Stun();
 }
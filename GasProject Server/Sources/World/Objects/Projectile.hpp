@@ -3,6 +3,9 @@
 #include "Object.hpp"
 
 class Projectile : public Object {
+public:
+	static const uint KIND = Object::KIND | ObjectKind::Projectile;
+
 protected:
     Projectile(uf::vec2i direction);
 
@@ -14,6 +17,7 @@ public:
 
 protected:
     virtual void onHit(Object *);
+	virtual void Serialize(uf::Archive &ar) final;
 
 private:
 	const float speed = 10;
@@ -1,7 +1,6 @@
 #include "Taser.hpp"
 
-#include <IGame.h>
-#include <World/World.hpp>
+#include <World/Objects/ObjectHolder.h>
 #include <World/Tile.hpp>
 #include <World/Objects/Projectile.hpp>
 
@@ -18,5 +17,5 @@ void Taser::InteractWith(Object *obj) {
 		return;
 
 	uf::vec2i direction = (obj->GetTile()->GetPos() - GetTile()->GetPos()).xy();
-	GGame->GetWorld()->CreateObject<Projectile>(GetTile(), direction);
+	GetObjectHolder()->CreateObject<Projectile>(GetTile(), direction);
 }
@@ -3,6 +3,9 @@
 #include "Item.hpp"
 
 class Taser : public Item {
+public:
+	static const uint KIND = Item::KIND | ObjectKind::Taser;
+
 protected:
     Taser();
 
@@ -2,6 +2,8 @@
 
 #include <functional>
 
+#include "IServer.h"
+#include "Resources/ResourceManager.hpp"
 #include "World/World.hpp"
 #include "Network/Differences.hpp"
 
@@ -9,15 +11,44 @@ Airlock::Airlock() {
     name = "airlock";
     sprite = "airlock";
     density = true;
+    airtight = true;
     opened = false;
     locked = false;
 }
 
+void Airlock::bindTimers(uf::TimerWheel *timers) {
+	Turf::bindTimers(timers);
+	closeTimer.Bind(timers);
+}
+
+void Airlock::Serialize(uf::Archive &ar) {
+	Turf::Serialize(ar);
+	ar & locked;
+	// Opening animation isn't saved, so the airlock is saved already opened
+	bool openedState = opened || !closeTimer.IsStopped();
+	ar & openedState;
+	sf::Time closeTimeLeft = closeTimer.GetTimeLeft();
+	ar & closeTimeLeft;
+	if (ar.IsOutput()) {
+		opened = openedState;
+		if (opened) {
+			SetDensity(false);
+			SetAirtight(false);
+		}
+		if (closeTimeLeft != sf::Time::Zero)
+			closeTimer.Start(closeTimeLeft, std::bind(&Airlock::autocloseCallback, this));
+	}
+}
+
 void Airlock::Update(sf::Time timeElapsed) {
 	Turf::Update(timeElapsed);
 	closeTimer.Update(timeElapsed);
 }
 
+bool Airlock::IsActive() const {
+	return Turf::IsActive() || closeTimer.NeedsUpdate();
+}
+
 bool Airlock::InteractedBy(Object *object) {
 	if (!IsCloseTo(object))
 		return false;
@@ -26,25 +57,35 @@ bool Airlock::InteractedBy(Object *object) {
 }
 
 void Airlock::Activate() {
+	// Resolved once for all airlocks
+	static const IconID closedSprite = GServer->GetRM()->GetIconID("airlock");
+	static const IconID openedSprite = GServer->GetRM()->GetIconID("airlock_opened");
+	static const IconID lockedAnimation = GServer->GetRM()->GetIconID("airlock_closed_animation");
+	static const IconID closingAnimation = GServer->GetRM()->GetIconID("airlock_closing");
+	static const IconID openingAnimation = GServer->GetRM()->GetIconID("airlock_opening");
+
 	// Blink if locked 
     if (locked) {
         if (!opened) {
-            PlayAnimation("airlock_closed_animation");
+            PlayAnimation(lockedAnimation);
         }
         return;
     }
 
 	if (opened) {
-		if (!PlayAnimation("airlock_closing"))
+		if (!PlayAnimation(closingAnimation))
 			return;
-		SetSprite("airlock");
+		SetSprite(closedSprite);
 		opened = false;
-		density = true;
+		SetDensity(true);
+		SetAirtight(true);
 	} else {
-		if (!PlayAnimation("airlock_opening", std::bind(&Airlock::animationOpeningCallback, this)))
+		if (!PlayAnimation(openingAnimation, std::bind(&Airlock::animationOpeningCallback, this)))
 			return;
-		SetSprite("airlock_opened");
+		SetSprite(openedSprite);
 		closeTimer.Start(AUTOCLOSE_TIME, std::bind(&Airlock::autocloseCallback, this));
+		if (closeTimer.NeedsUpdate())
+			Wake();
 	}
 }
 
@@ -56,9 +97,14 @@ void Airlock::Unlock() {
     locked = false;
 }
 
+bool Airlock::IsLocked() const {
+    return locked;
+}
+
 void Airlock::animationOpeningCallback() {
 	opened = true;
-	density = false;
+	SetDensity(false);
+	SetAirtight(false);
 }
 
 void Airlock::autocloseCallback() {
@@ -5,16 +5,25 @@
 #include <Shared/Timer.h>
 
 class Airlock : public Turf {
+public:
+	static const uint KIND = Turf::KIND | ObjectKind::Airlock;
+
 protected:
     Airlock();
 
 public:
 	virtual void Update(sf::Time timeElapsed) final;
+	virtual bool IsActive() const final;
     virtual bool InteractedBy(Object *) final;
 
     void Activate();
     void Lock();
     void Unlock();
+    bool IsLocked() const;
+
+protected:
+	virtual void bindTimers(uf::TimerWheel *timers) final;
+	virtual void Serialize(uf::Archive &ar) final;
 
 private:
 	void animationOpeningCallback();
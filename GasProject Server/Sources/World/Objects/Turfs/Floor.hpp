@@ -3,6 +3,9 @@
 #include "Turf.hpp"
 
 class Floor : public Turf {
+public:
+	static const uint KIND = Turf::KIND | ObjectKind::Floor;
+
 protected:
     Floor() {
         layer = 15;
@@ -3,6 +3,9 @@
 #include "World/Objects/Object.hpp"
 
 class Turf : public Object {
+public:
+	static const uint KIND = Object::KIND | ObjectKind::Turf;
+
 protected:
     Turf() {
         layer = 25;
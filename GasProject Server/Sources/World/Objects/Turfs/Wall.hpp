@@ -3,6 +3,9 @@
 #include "Turf.hpp"
 
 class Wall : public Turf {
+public:
+	static const uint KIND = Turf::KIND | ObjectKind::Wall;
+
 protected:
     Wall() {
         sprite = "wall";
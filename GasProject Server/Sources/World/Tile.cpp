@@ -1,5 +1,7 @@
 #include "Tile.hpp"
 
+#include <algorithm>
+
 #include <plog/Log.h>
 
 #include <IServer.h>
@@ -10,83 +12,68 @@
 #include <World/Objects.hpp>
 #include <World/Atmos/Atmos.hpp>
 
-Tile::Tile(Map *map, apos pos) :
-    map(map), pos(pos),
-    hasFloor(false), fullBlocked(false), directionsBlocked(4, false),
-    locale(nullptr), needToUpdateLocale(false), gases(int(Gas::Count), 0)
+Tile::Tile(Map *map, MapChunk *chunk, apos pos) :
+    map(map), chunk(chunk),
+    index((pos.y % MapChunk::SIZE) * MapChunk::SIZE + pos.x % MapChunk::SIZE), pos(pos),
+    denseCount(0),
+    airtightCount(0),
+    directionsBlocked(4, false),
+    localeIndex(0),
+    spaceNeighbours(0),
+    searchStamp(0), searchIndex(0)
 {
-    uint ux = uint(pos.x);
-    uint uy = uint(pos.y);
-	icon = GServer->GetRM()->GetIconInfo("space");
-	icon.id += ((ux + uy) ^ ~(ux * uy)) % 25;
-
-    totalPressure = 0;
+	icon = spaceIcon(pos);
 }
 
 void Tile::Update(sf::Time timeElapsed) {
     // Update locale, if wall/floor state was changed
-    if (needToUpdateLocale) {
-        // Atmos-available tile
-        if (hasFloor && !fullBlocked) {
-            for (int dx = -1; dx <= 1; dx++)
-                for (int dy = -1; dy <= 1; dy++) {
-                    Tile *neighbour = map->GetTile(pos + rpos(dx, dy, 0));
-                    if (!neighbour ||
-                        dx == 0 && dy == 0 ||
-                        dx * dy != 0) // diag tiles
-                        continue;
-                    if (neighbour->locale) {
-                        if (locale) {
-                            locale->Merge(neighbour->locale);
-                        } else {
-                            neighbour->locale->AddTile(this);
-                            locale = neighbour->locale;
-                        }
-                    }
-                }
-            if (!locale) {
-                map->GetAtmos()->CreateLocale(this);
+    if (!(chunk->state[index] & MapChunk::NEED_TO_UPDATE_LOCALE))
+        return;
+
+    Atmos *atmos = map->GetAtmos();
+    Locale *locale = GetLocale();
+    // Neighbours in untouched chunks are space without locales, so they aren't allocated here
+    if (isAtmosAvailable()) {
+        if (!locale) {
+            // Join the biggest neighbour locale and merge the rest into it, so the fewest tiles move
+            Locale *neighbours[4];
+            int count = 0;
+            Locale *biggest = nullptr;
+            for (auto side : { rpos(1, 0, 0), rpos(-1, 0, 0), rpos(0, 1, 0), rpos(0, -1, 0) }) {
+                Tile *neighbour = map->FindTile(pos + side);
+                Locale *neighbourLocale = neighbour ? neighbour->GetLocale() : nullptr;
+                if (!neighbourLocale || std::find(neighbours, neighbours + count, neighbourLocale) != neighbours + count)
+                    continue;
+                neighbours[count++] = neighbourLocale;
+                if (!biggest || neighbourLocale->NumOfTiles() > biggest->NumOfTiles())
+                    biggest = neighbourLocale;
             }
-        } else { // Space
-            if (!hasFloor && !fullBlocked) {
-                for (int dx = -1; dx <= 1; dx++)
-                    for (int dy = -1; dy <= 1; dy++) {
-                        Tile *neighbour = map->GetTile(pos + rpos(dx, dy, 0));
-                        if (!neighbour ||
-                            dx == 0 && dy == 0 ||
-                            dx * dy != 0) // diag tiles
-                            continue;
-                        if (neighbour->locale) {
-                            neighbour->locale->Open();
-                        }
-                    }
-                if (locale) locale->RemoveTile(this);
-            } else { // fullBlocked
-                // if here was locale then remove it
-                if (locale) { 
-                    map->GetAtmos()->RemoveLocale(locale);
-                }
-                // if here was a space then we need to update neighbors locals 
-                // so we delete them, after that Atmos::Update recreate them
-                for (int dx = -1; dx <= 1; dx++)
-                    for (int dy = -1; dy <= 1; dy++) {
-                        Tile *neighbour = map->GetTile(pos + rpos(dx, dy, 0));
-                        if (!neighbour ||
-                            dx == 0 && dy == 0 ||
-                            dx * dy != 0) // diag tiles
-                            continue;
-                        if (neighbour->locale) {
-                            neighbour->locale->CheckCloseness();
-                        }
-                    }
+            if (biggest) {
+                biggest->AddTile(this);
+                for (int i = 0; i < count; i++)
+                    if (neighbours[i] != biggest)
+                        biggest->Merge(neighbours[i]);
+            } else {
+                atmos->CreateLocale(this);
             }
         }
-        needToUpdateLocale = false;
+    } else {
+        if (locale) {
+            locale->RemoveTile(this);
+            // The rest of the locale may be cut in parts by the wall or the closed airlock
+            atmos->CheckSplit(locale, pos);
+        }
+        // Gas of the tile goes to space, or the wall takes its place
+        gases.Clear();
     }
+
+    setNeedToUpdateLocale(false);
 }
 
 void Tile::CheckLocale() {
-    needToUpdateLocale = true;
+    setNeedToUpdateLocale(true);
+    if (Locale *locale = GetLocale())
+        locale->Wake();
 }
 
 bool Tile::RemoveObject(Object *obj) {
@@ -105,12 +92,8 @@ bool Tile::MoveTo(Object *obj) {
         return false;
     }
 
-    if (obj->GetDensity())
-        for (auto &object : content)
-            if (object)
-                if (object->GetDensity()) {
-                    return false;
-                }
+    if (obj->GetDensity() && IsDense())
+        return false;
 
     Tile *lastTile = obj->GetTile();
     rpos delta = GetPos() - lastTile->GetPos();
@@ -132,32 +115,34 @@ void Tile::PlaceTo(Object *obj) {
     Tile *lastTile = obj->GetTile();
 
     // If obj is wall or floor - remove previous and change status
-    if (dynamic_cast<Floor *>(obj)) {
-        if (hasFloor) {
+    if (obj->Is(ObjectKind::Floor)) {
+        if (hasFloor()) {
             for (auto iter = content.begin(); iter != content.end(); iter++) {
-                if (dynamic_cast<Floor *>(*iter)) {
+                if ((*iter)->Is(ObjectKind::Floor)) {
+                    onObjectLeft(*iter);
                     content.erase(iter);
                     break;
                 }
             }
         }
-        hasFloor = true;
+        setState(MapChunk::FLOOR, true);
         CheckLocale();
-    } else if (dynamic_cast<Wall *>(obj)) {
-        if (!hasFloor) {
+    } else if (obj->Is(ObjectKind::Wall)) {
+        if (!hasFloor()) {
             LOGW << "Warning! Try to place wall without floor";
             return;
         }
-        if (fullBlocked) {
+        if (fullBlocked()) {
             for (auto iter = content.begin(); iter != content.end(); iter++) {
-                if (dynamic_cast<Wall *>(*iter)) {
+                if ((*iter)->Is(ObjectKind::Wall)) {
+                    onObjectLeft(*iter);
                     content.erase(iter);
                     break;
                 }
             }
             
         }
-        fullBlocked = true;
+        setState(MapChunk::FULL_BLOCKED, true);
         CheckLocale();
     }
 
@@ -165,12 +150,14 @@ void Tile::PlaceTo(Object *obj) {
     AddDiff(new ReplaceDiff(obj, pos.x, pos.y, pos.z, lastTile));
 }
 
-const list<Object *> &Tile::Content() const {
+const uf::SmallVector<Object *, 4> &Tile::Content() const {
     return content;
 }
 
 Object *Tile::GetDenseObject() const
 {
+    if (!denseCount)
+        return nullptr;
     for (auto &obj : content)
         if (obj->GetDensity()) return obj;
     return nullptr;
@@ -182,18 +169,26 @@ apos Tile::GetPos() const {
 
 Map *Tile::GetMap() const { return map; }
 
-bool Tile::IsDense() const {
-    for (auto &obj : content)
-        if (obj->GetDensity()) return true;
-    return false;
-}
-
 bool Tile::IsSpace() const {
-    return !hasFloor && !fullBlocked;
+    return !(chunk->state[index] & (MapChunk::FLOOR | MapChunk::FULL_BLOCKED));
 }
 
 Locale *Tile::GetLocale() const {
-	return locale;
+	return chunk->locales[index];
+}
+
+pressure Tile::GetPressure(Gas gas) const {
+    Locale *locale = GetLocale();
+    return locale ? locale->GetPressure(gas) : gases[gas];
+}
+
+pressure Tile::GetTotalPressure() const {
+    Locale *locale = GetLocale();
+    return locale ? locale->GetTotalPressure() : gases.Total();
+}
+
+temperature Tile::GetTemperature() const {
+    return map->GetHeat()->GetTemperature(this);
 }
 
 const TileInfo Tile::GetTileInfo(uint visibility) const {
@@ -201,7 +196,7 @@ const TileInfo Tile::GetTileInfo(uint visibility) const {
 	tileInfo.x = pos.x;
 	tileInfo.y = pos.y;
 	tileInfo.z = pos.z;
-	tileInfo.sprite = icon.id;
+	tileInfo.sprite = icon;
 
 	for (auto &obj : this->content) {
 		if (obj->CheckVisibility(visibility))
@@ -211,10 +206,30 @@ const TileInfo Tile::GetTileInfo(uint visibility) const {
     return tileInfo;
 }
 
+TileInfo Tile::GetSpaceTileInfo(apos pos) {
+	TileInfo tileInfo;
+	tileInfo.x = pos.x;
+	tileInfo.y = pos.y;
+	tileInfo.z = pos.z;
+	tileInfo.sprite = spaceIcon(pos);
+	return tileInfo;
+}
+
+IconID Tile::spaceIcon(apos pos) {
+    uint ux = uint(pos.x);
+    uint uy = uint(pos.y);
+	// Tiles are created by thousands, the name is looked up once
+	static const IconID space = GServer->GetRM()->GetIconID("space");
+	return space + ((ux + uy) ^ ~(ux * uy)) % 25;
+}
+
 void Tile::addObject(Object *obj) {
 	if (!obj)
 		return;
 
+	// Region around the object has to exist before it's seen or moves further
+	map->Touch(pos);
+
 	Object *holder = obj->GetHolder();
 	if (holder) {
 		if (!holder->RemoveObject(obj))
@@ -232,6 +247,7 @@ void Tile::addObject(Object *obj) {
     while (iter != content.end() && (*iter)->GetLayer() <= obj->GetLayer())
         iter++;
     content.insert(iter, obj);
+    onObjectEntered(obj);
 
 	obj->setTile(this);
 	obj->SetSpriteState(Global::ItemSpriteState::DEFAULT);
@@ -240,14 +256,15 @@ void Tile::addObject(Object *obj) {
 bool Tile::removeObject(Object *obj) {
     for (auto iter = content.begin(); iter != content.end(); iter++) {
         if (*iter == obj) {
-            if (dynamic_cast<Floor *>(obj)) {
-                hasFloor = false;
+            if (obj->Is(ObjectKind::Floor)) {
+                setState(MapChunk::FLOOR, false);
                 CheckLocale();
-            } else if (dynamic_cast<Wall *>(obj)) {
-                fullBlocked = false;
+            } else if (obj->Is(ObjectKind::Wall)) {
+                setState(MapChunk::FULL_BLOCKED, false);
                 CheckLocale();
             }
             obj->setTile(nullptr);
+            onObjectLeft(obj);
             content.erase(iter);
             return true;
         }
@@ -255,10 +272,115 @@ bool Tile::removeObject(Object *obj) {
     return false;
 }
 
+void Tile::onObjectEntered(Object *obj) {
+    if (obj->GetDensity())
+        changeDensity(1);
+    if (obj->IsAirtight())
+        changeAirtightness(1);
+    map->objectsIndex.Insert(obj, pos.x, pos.y, pos.z, obj->GetKind());
+}
+
+void Tile::onObjectLeft(Object *obj) {
+    if (obj->GetDensity())
+        changeDensity(-1);
+    if (obj->IsAirtight())
+        changeAirtightness(-1);
+    map->objectsIndex.Remove(obj, pos.x, pos.y, pos.z);
+}
+
+void Tile::changeDensity(int delta) {
+    bool wasDense = denseCount;
+    denseCount += delta;
+    if (wasDense != bool(denseCount))
+        map->setBlocked(pos, denseCount);
+}
+
+void Tile::changeAirtightness(int delta) {
+    bool wasAirtight = airtightCount;
+    airtightCount += delta;
+    if (wasAirtight != bool(airtightCount))
+        CheckLocale();
+}
+
 void Tile::AddDiff(Diff *diff) {
+    auto &differences = chunk->differences[index];
+    if (differences.empty())
+        map->onDiffAdded(chunk, index);
     differences.push_back(sptr<Diff>(diff));
 }
 
+const list<sptr<Diff>> &Tile::GetDifferences() const {
+    return chunk->differences[index];
+}
+
 void Tile::ClearDiffs() {
-    differences.clear();
+    chunk->differences[index].clear();
+}
+
+bool Tile::hasFloor() const {
+    return chunk->state[index] & MapChunk::FLOOR;
+}
+
+bool Tile::fullBlocked() const {
+    return chunk->state[index] & MapChunk::FULL_BLOCKED;
+}
+
+bool Tile::isAtmosAvailable() const {
+    return hasFloor() && !fullBlocked() && !airtightCount;
+}
+
+void Tile::setState(uint8_t flag, bool value) {
+    bool wasSpace = IsSpace();
+    if (value)
+        chunk->state[index] |= flag;
+    else
+        chunk->state[index] &= ~flag;
+    if (flag & (MapChunk::FLOOR | MapChunk::FULL_BLOCKED)) {
+        // Conductivity follows floors and walls
+        map->GetHeat()->OnStateChanged(chunk);
+        if (IsSpace() != wasSpace)
+            onSpaceChanged();
+    }
+}
+
+uint Tile::countSpaceNeighbours() const {
+    uint count = 0;
+    for (int dx = -1; dx <= 1; dx++)
+        for (int dy = -1; dy <= 1; dy++) {
+            apos neighbourPos = pos + rpos(dx, dy, 0);
+            if (dx == 0 && dy == 0 || !(neighbourPos < map->GetSize()))
+                continue;
+            // Not allocated tile is untouched space
+            Tile *neighbour = map->FindTile(neighbourPos);
+            if (!neighbour || neighbour->IsSpace())
+                count++;
+        }
+    return count;
+}
+
+void Tile::onSpaceChanged() {
+    int delta = IsSpace() ? 1 : -1;
+    for (int dx = -1; dx <= 1; dx++)
+        for (int dy = -1; dy <= 1; dy++) {
+            Tile *neighbour = map->FindTile(pos + rpos(dx, dy, 0));
+            if (!neighbour || dx == 0 && dy == 0)
+                continue;
+            if (Locale *neighbourLocale = neighbour->GetLocale())
+                neighbourLocale->ChangeBreaches(neighbour, delta);
+        }
+}
+
+void Tile::setLocale(Locale *locale) {
+    chunk->locales[index] = locale;
+}
+
+void Tile::setNeedToUpdateLocale(bool value) {
+    bool was = chunk->state[index] & MapChunk::NEED_TO_UPDATE_LOCALE;
+    if (was == value)
+        return;
+    setState(MapChunk::NEED_TO_UPDATE_LOCALE, value);
+    if (value)
+        map->onLocaleUpdateNeeded(chunk);
+    else
+        chunk->pendingUpdates--;
 }
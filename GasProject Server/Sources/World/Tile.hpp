@@ -6,9 +6,11 @@
 #include <SFML/System.hpp>
 
 #include <World/Atmos/Gases.hpp>
+#include <World/Atmos/Heat.hpp>
 #include <Resources/IconInfo.h>
 
 #include <Shared/Global.hpp>
+#include <Shared/SmallVector.hpp>
 #include <Shared/Types.hpp>
 
 using std::list;
@@ -16,7 +18,11 @@ using std::vector;
 
 class Object;
 class Map;
+struct MapChunk;
 class Locale;
+class Atmos;
+class Heat;
+class WorldSnapshot;
 
 struct Diff;
 struct TileInfo;
@@ -24,7 +30,12 @@ struct TileInfo;
 class Tile {
 public:
     friend Locale;
-    Tile(Map *map, apos pos);
+    friend Atmos;
+    friend Heat;
+    friend WorldSnapshot;
+    friend Object;
+    // Tiles are created by the map together with the chunk holding their state
+    Tile(Map *map, MapChunk *chunk, apos pos);
 
     void Update(sf::Time timeElapsed);
 
@@ -39,19 +50,29 @@ public:
 	// Teleport or add to tile from nowhere
     void PlaceTo(Object *);
 
-    const list<Object *> &Content() const;
+    const uf::SmallVector<Object *, 4> &Content() const;
+    // Null if the tile isn't dense
     Object *GetDenseObject() const;
 
     apos GetPos() const;
     Map *GetMap() const;
-    bool IsDense() const;
+    // Dense objects are counted when they enter or leave the tile, so it's O(1)
+    bool IsDense() const { return denseCount; }
     bool IsSpace() const;
 	Locale *GetLocale() const;
+    // Partial pressure of the gas, kPa. Tiles of a locale share its mixture.
+    pressure GetPressure(Gas gas) const;
+    pressure GetTotalPressure() const;
+    // Kelvins, see Heat
+    temperature GetTemperature() const;
 
     const TileInfo GetTileInfo(uint visibility) const;
+    // Info of a tile in a chunk nobody has touched, it's space without content
+    static TileInfo GetSpaceTileInfo(apos pos);
 
     void AddDiff(Diff *diff);
-    const list<sptr<Diff>> GetDifferences() const { return differences; }
+    // Safe to read from several threads while nobody changes the map
+    const list<sptr<Diff>> &GetDifferences() const;
     void ClearDiffs();
 
     int X() const { return pos.x; }
@@ -60,28 +81,56 @@ public:
 
 private:
     Map *map;
+    // Floor and wall flags, locale and differences are read by passes over the whole map,
+    // so they are packed in arrays of the chunk instead of the tile, see MapChunk
+    MapChunk *chunk;
+    uint index;
     apos pos;
-    IconInfo icon;
+    IconID icon;
 
-    list<Object *> content;
-    bool hasFloor;
-    // true if has wall
-    bool fullBlocked;
+    // Ordered by layer. Most tiles have up to 4 objects: floor, wall or something on the floor.
+    uf::SmallVector<Object *, 4> content;
+    uint denseCount;
+    // Closed airlocks and such, they seal the tile like a wall
+    uint airtightCount;
     // for thin walls
     vector<bool> directionsBlocked;
 
-
-    Locale *locale;
-    bool needToUpdateLocale;
-    // Partional pressures of gases by index
-    vector<pressure> gases;
-    pressure totalPressure;
-
-    list<sptr<Diff>> differences;
+    // Gas of the tile while it isn't in a locale, locales take it when the tile joins them
+    GasMixture gases;
+    // Index in Locale::tiles
+    uint localeIndex;
+    // Neighbours which are space, kept up to date while the tile is in a locale
+    uint spaceNeighbours;
+    // For Atmos::CheckSplit
+    uint searchStamp;
+    uint searchIndex;
+
+    bool hasFloor() const;
+    // true if has wall
+    bool fullBlocked() const;
+    // Floor without a wall or airtight objects: tile is a part of a locale
+    bool isAtmosAvailable() const;
+    void setState(uint8_t flag, bool value);
+    // Positions out of the map aren't counted
+    uint countSpaceNeighbours() const;
+    // Locales around got or lost a breach
+    void onSpaceChanged();
+    void setLocale(Locale *locale);
+    // Chunk counts tiles waiting for the update, so the map visits only such chunks
+    void setNeedToUpdateLocale(bool value);
+
+    // Space sprites vary by position
+    static IconID spaceIcon(apos pos);
 
     // Add object to the tile, and change object.tile pointer
     // For moving use MoveTo, for placing PlaceTo
     void addObject(Object *obj);
     // Not generate Diff
     bool removeObject(Object *obj);
+    // Call when object enters or leaves the content: density is counted and the map's indices follow the tile
+    void onObjectEntered(Object *obj);
+    void onObjectLeft(Object *obj);
+    void changeDensity(int delta);
+    void changeAirtightness(int delta);
 };
\ No newline at end of file
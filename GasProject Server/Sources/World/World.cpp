@@ -1,16 +1,25 @@
 #include "World.hpp"
 
+#include <Global.hpp>
+
+#include <Shared/Trace.hpp>
+
 #include "Map.hpp"
 #include "Tile.hpp"
+#include "Atmos/Atmos.hpp"
 #include "Objects.hpp"
 #include "Objects/Control.hpp"
 #include "Player.hpp"
 
 World::World() : 
-	map(new Map(100, 100, 3))
+	map(new Map(100, 100, 3)),
+	timers(sf::seconds(1.f / Global::TicksPerSecond)),
+	testMob(nullptr), testMob_lastPosition(nullptr)
 { }
 
 void World::Update(sf::Time timeElapsed) {
+    TRACE_SCOPE("World::Update");
+
     map->ClearDiffs();
 
 	// Simple walking mob AI for moving testing
@@ -28,19 +37,37 @@ void World::Update(sf::Time timeElapsed) {
     
     map->Update(timeElapsed);
 
-    // update objects
-    for (uint i = 0; i < objects.size(); i++) {
-        if (!objects[i].get()) continue; // already deleted
-        if (!objects[i]->ID()) {         // waiting for delete
-            objects[i].release();
-            free_ids.push_back(i + 1);
-            continue;
-        }
-        objects[i]->Update(timeElapsed);
+    {
+        TRACE_SCOPE("World::Timers");
+        timers.Advance(timeElapsed);
     }
+
+    // update objects
+    TRACE_SCOPE("World::UpdateObjects");
+    updateObjects(timeElapsed);
+}
+
+bool World::LoadMap(const std::string &path) {
+	auto file = MapFile::Open(path);
+	if (!file)
+		return false;
+	map = std::make_unique<Map>(std::move(file), this);
+	return true;
 }
 
 void World::FillingWorld() {
+	// Turfs and items of the loaded map are created when their region is touched
+	if (!map->GetFile())
+		fillingMap();
+
+	testMob = CreateObject<Ghost>({ 49, 49, 0 });
+	testMob_lastPosition = nullptr;
+
+    test_dx = 1;
+    test_dy = 0;
+}
+
+void World::fillingMap() {
     for (uint i = 45; i <= 55; i++) {
         for (uint j = 45; j <= 55; j++) {
 			CreateObject<Floor>({ i, j, 0 });
@@ -66,17 +93,14 @@ void World::FillingWorld() {
         }
     }
 
-	testMob = CreateObject<Ghost>({ 49, 49, 0 });
-	testMob_lastPosition = nullptr;
-
-    test_dx = 1;
-    test_dy = 0;
-
     for (uint i = 85; i <= 95; i++) {
         for (uint j = 85; j <= 95; j++) {
 			CreateObject<Floor>({ i, j, 0 });
         }
     }
+
+	Atmos *atmos = map->GetAtmos();
+	map->ForEachTile([atmos](Tile *tile) { atmos->FillWithAir(tile); });
 }
 
 Creature *World::CreateNewPlayerCreature() {
@@ -90,16 +114,10 @@ Creature *World::CreateNewPlayerCreature() {
     return human;
 }
 
-Object *World::GetObject(uint id) const {
-    if (id <= objects.size()) {
-        Object *object = objects[id - 1].get();
-        if (!object || !object->ID())
-            return nullptr; // object deleted
-        return object;
-    }
-    return nullptr;
-}
-
 Map *World::GetMap() const {
 	return map.get();
 }
+
+uf::TimerWheel *World::GetTimers() {
+	return &timers;
+}
@@ -7,23 +7,33 @@ using std::vector;
 
 class Map;
 class Creature;
+class WorldSnapshot;
 
 class World : public ObjectHolder {
 public:
     friend Object;
+    friend WorldSnapshot;
 
     World();
 
     void Update(sf::Time timeElapsed);
 
+    virtual uf::TimerWheel *GetTimers() override;
+
+    // Replace the empty map by the map file. False if there is no valid file.
+    bool LoadMap(const std::string &path);
     void FillingWorld();
     Creature *CreateNewPlayerCreature();
 
-    Object *GetObject(uint id) const;
-	Map *GetMap() const;
+	Map *GetMap() const override;
+
+private:
+    // Hard-coded station for the case there is no map file
+    void fillingMap();
 
 private:
     uptr<Map> map;
+    uf::TimerWheel timers;
 
     Creature *testMob;
     Tile *testMob_lastPosition;
@@ -0,0 +1,396 @@
+#include "WorldSnapshot.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <plog/Log.h>
+
+#include <Shared/Array.hpp>
+#include <Shared/CRC32.h>
+
+#include "World.hpp"
+#include "Map.hpp"
+#include "Tile.hpp"
+#include "Objects.hpp"
+#include "Atmos/Atmos.hpp"
+
+namespace {
+
+const sf::Uint32 SNAPSHOT_MAGIC = "OSS-13 World Snapshot"_crc32;
+// Increase on any change of the format
+const sf::Uint32 SNAPSHOT_VERSION = 5;
+
+sf::Uint32 checksum(const char *data, size_t size) {
+	unsigned int crc = 0xFFFFFFFF;
+	for (size_t i = 0; i < size; i++)
+		crc = crc32_table[static_cast<unsigned char>(crc) ^ static_cast<unsigned char>(data[i])] ^ (crc >> 8);
+	return crc ^ 0xFFFFFFFF;
+}
+
+bool isDefault(const Tile *tile) {
+	if (!tile->Content().empty() || !tile->IsSpace() || tile->GetLocale())
+		return false;
+	return true;
+}
+
+// Inverse of uf::flat_index, positions past the last z-level are out of the map
+apos positionOf(sf::Uint32 index, apos size) {
+	return apos(index % size.x, index / size.x % size.y, index / (size.x * size.y));
+}
+
+}
+
+template<typename T, typename... TArgs>
+WorldSnapshot::ObjectType WorldSnapshot::objectType(TArgs... args) {
+	return {
+		std::type_index(typeid(::detail::Factory<T>)),
+		[args...](ObjectHolder *holder, uint id) -> Object * {
+			return holder->restoreObject<T>(id, args...);
+		}
+	};
+}
+
+const std::vector<WorldSnapshot::ObjectType> &WorldSnapshot::objectTypes() {
+	// Index of the type is saved, so add new types to the end only
+	static const std::vector<ObjectType> types = {
+		objectType<Floor>(),
+		objectType<Wall>(),
+		objectType<Airlock>(),
+		objectType<Taser>(),
+		objectType<Uniform>(),
+		objectType<Human>(),
+		objectType<Ghost>(),
+		objectType<Projectile>(uf::vec2i(1, 0)) // speed is loaded from the snapshot
+	};
+	return types;
+}
+
+void WorldSnapshot::Save(World *world, sf::Packet &packet) {
+	uf::InputArchive ar(packet);
+
+	sf::Uint32 magic = SNAPSHOT_MAGIC;
+	sf::Uint32 version = SNAPSHOT_VERSION;
+	apos size = world->GetMap()->GetSize();
+	ar & magic & version & size.x & size.y & size.z;
+
+	serializeChunks(world, ar);
+	serializeObjects(world, ar);
+	serializeTiles(world, ar);
+	serializeLocales(world, ar);
+	serializeWorld(world, ar);
+}
+
+bool WorldSnapshot::Load(World *world, sf::Packet &packet) {
+	uf::OutputArchive ar(packet);
+
+	try {
+		sf::Uint32 magic, version;
+		apos size;
+		ar & magic & version & size.x & size.y & size.z;
+		if (!packet || magic != SNAPSHOT_MAGIC) {
+			LOGE << "Snapshot loading error: it's not a world snapshot";
+			return false;
+		}
+		if (version != SNAPSHOT_VERSION) {
+			LOGE << "Snapshot loading error: version " << version << " is not supported";
+			return false;
+		}
+		apos mapSize = world->GetMap()->GetSize();
+		if (size.x != mapSize.x || size.y != mapSize.y || size.z != mapSize.z) {
+			LOGE << "Snapshot loading error: map size doesn't match";
+			return false;
+		}
+
+		serializeChunks(world, ar);
+		serializeObjects(world, ar);
+		serializeTiles(world, ar);
+		serializeLocales(world, ar);
+		serializeWorld(world, ar);
+
+		if (!packet || !packet.endOfPacket())
+			throw std::exception(); // "Snapshot size doesn't match the data"
+	} catch (const std::exception &) {
+		LOGE << "Snapshot loading error: data is broken";
+		return false;
+	}
+
+	// Icons aren't saved, so every object sends them on the first update
+	for (auto &slot : world->objects)
+		if (slot.object && slot.object->ID())
+			slot.object->askToUpdateIcons();
+
+	return true;
+}
+
+bool WorldSnapshot::WriteFile(const std::string &path, const sf::Packet &packet) {
+	const char *data = static_cast<const char *>(packet.getData());
+	size_t size = packet.getDataSize();
+	sf::Uint32 crc = checksum(data, size);
+
+	std::string tempPath = path + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file.write(data, size);
+		file.write(reinterpret_cast<const char *>(&crc), sizeof(crc));
+		if (!file) {
+			LOGE << "Failed to write snapshot to " << tempPath;
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, path, error);
+	if (error) {
+		LOGE << "Failed to replace snapshot " << path << ": " << error.message();
+		return false;
+	}
+	return true;
+}
+
+bool WorldSnapshot::ReadFile(const std::string &path, sf::Packet &packet) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	sf::Uint32 crc;
+	if (data.size() < sizeof(crc)) {
+		LOGE << "Snapshot " << path << " is truncated";
+		return false;
+	}
+	size_t size = data.size() - sizeof(crc);
+	std::copy(data.begin() + size, data.end(), reinterpret_cast<char *>(&crc));
+	if (crc != checksum(data.data(), size)) {
+		LOGE << "Snapshot " << path << " is corrupted";
+		return false;
+	}
+
+	packet.clear();
+	packet.append(data.data(), size);
+	return true;
+}
+
+void WorldSnapshot::serializeChunks(World *world, uf::Archive &ar) {
+	Map *map = world->GetMap();
+	bool loading = ar.IsOutput();
+
+	// Chunks of the map file which aren't materialized yet are still created from the file
+	bool paged = map->GetFile() != nullptr;
+	ar & paged;
+	if (paged != (map->GetFile() != nullptr))
+		throw std::exception(); // "Snapshot and world disagree about the map file"
+	if (!paged)
+		return;
+
+	sf::Uint32 count = sf::Uint32(map->materializedChunks.size());
+	ar & count;
+	if (count != map->materializedChunks.size())
+		throw std::exception(); // "Map file doesn't match the snapshot"
+	for (sf::Uint32 i = 0; i < count; i++) {
+		bool materialized = map->materializedChunks[i];
+		bool touched = map->touchedChunks[i];
+		ar & materialized & touched;
+		if (loading) {
+			map->materializedChunks[i] = materialized;
+			map->touchedChunks[i] = touched;
+		}
+	}
+}
+
+void WorldSnapshot::serializeObjects(World *world, uf::Archive &ar) {
+	auto &types = objectTypes();
+	auto &objects = world->objects;
+	bool loading = ar.IsOutput();
+
+	sf::Uint32 count = sf::Uint32(objects.size());
+	ar & count;
+	if (loading) {
+		if (!objects.empty())
+			throw std::exception(); // "World isn't empty"
+		if (count > ObjectHolder::ID_INDEX_MASK)
+			throw std::exception(); // "Too many objects"
+		objects.resize(count);
+	}
+
+	// Types first, so references between objects can be resolved on loading.
+	// Generations of free slots are kept too, so IDs taken before saving stay stale.
+	for (sf::Uint32 i = 0; i < count; i++) {
+		sf::Int32 typeIndex = -1;
+		sf::Uint32 generation = 0;
+		if (!loading) {
+			Object *object = objects[i].object;
+			generation = objects[i].generation;
+			if (object && object->ID()) {
+				std::type_index type = typeid(*object);
+				for (size_t j = 0; j < types.size(); j++)
+					if (types[j].type == type)
+						typeIndex = sf::Int32(j);
+				if (typeIndex < 0)
+					throw std::exception(); // "Object type isn't registered in WorldSnapshot"
+			} else if (object) {
+				// Deleted object, the slot is freed after the tick
+				generation = (generation + 1) & ObjectHolder::ID_GENERATION_MASK;
+			}
+		}
+		ar & typeIndex & generation;
+		if (loading) {
+			if (generation > ObjectHolder::ID_GENERATION_MASK)
+				throw std::exception(); // "Wrong generation"
+			objects[i].generation = generation;
+			if (typeIndex >= 0) {
+				if (size_t(typeIndex) >= types.size())
+					throw std::exception(); // "Unknown object type"
+				types[typeIndex].restore(world, ObjectHolder::makeID(i, generation));
+			}
+		}
+	}
+
+	// Deleted objects are reclaimed after the tick, their slots are free already
+	std::vector<uint> freeSlots = world->freeSlots;
+	if (!loading)
+		for (uint id : world->deletedIds)
+			freeSlots.push_back((id & ObjectHolder::ID_INDEX_MASK) - 1);
+	sf::Uint32 freeCount = sf::Uint32(freeSlots.size());
+	ar & freeCount;
+	if (freeCount > count)
+		throw std::exception(); // "Wrong free slots"
+	freeSlots.resize(freeCount);
+	for (auto &index : freeSlots) {
+		ar & index;
+		if (loading && (index >= count || objects[index].object))
+			throw std::exception(); // "Wrong free slot"
+	}
+	if (loading)
+		world->freeSlots = std::move(freeSlots);
+
+	for (auto &slot : objects)
+		if (slot.object && slot.object->ID())
+			slot.object->Serialize(ar);
+}
+
+void WorldSnapshot::serializeTiles(World *world, uf::Archive &ar) {
+	Map *map = world->GetMap();
+	apos size = map->GetSize();
+	bool loading = ar.IsOutput();
+
+	// Most of the map is empty space, such tiles are skipped.
+	// Untouched chunks aren't even allocated, so only the allocated ones are visited.
+	std::vector<sf::Uint32> indices;
+	if (!loading) {
+		map->ForEachTile([&](Tile *tile) {
+			if (tile->GetPos() < size && !isDefault(tile))
+				indices.push_back(sf::Uint32(uf::flat_index(tile->GetPos(), size.x, size.y)));
+		});
+		// Chunks are allocated in order of access, keep the file independent of it
+		std::sort(indices.begin(), indices.end());
+	}
+
+	sf::Uint32 count = sf::Uint32(indices.size());
+	ar & count;
+	indices.resize(count);
+
+	for (auto &index : indices) {
+		ar & index;
+		Tile *tile = map->GetTile(positionOf(index, size));
+		if (!tile)
+			throw std::exception(); // "Tile is out of the map"
+
+		bool hasFloor = tile->hasFloor();
+		bool fullBlocked = tile->fullBlocked();
+		bool needToUpdateLocale = tile->chunk->state[tile->index] & MapChunk::NEED_TO_UPDATE_LOCALE;
+		ar & hasFloor & fullBlocked & needToUpdateLocale;
+		if (loading) {
+			tile->setState(MapChunk::FLOOR, hasFloor);
+			tile->setState(MapChunk::FULL_BLOCKED, fullBlocked);
+			tile->setNeedToUpdateLocale(needToUpdateLocale);
+		}
+		for (int gas = 0; gas < int(Gas::Count); gas++)
+			ar & tile->gases.gases[gas];
+		temperature tileTemperature = tile->GetTemperature();
+		ar & tileTemperature;
+		if (loading)
+			map->GetHeat()->SetTemperature(tile, tileTemperature);
+
+		sf::Uint32 contentSize = sf::Uint32(tile->content.size());
+		ar & contentSize;
+		if (loading) {
+			for (sf::Uint32 i = 0; i < contentSize; i++) {
+				sf::Uint32 id;
+				ar & id;
+				Object *object = world->GetObject(id);
+				if (!object || object->GetTile() || object->GetHolder())
+					throw std::exception(); // "Tile content is broken"
+				tile->content.push_back(object);
+				tile->onObjectEntered(object);
+				object->setTile(tile);
+			}
+		} else {
+			for (auto *object : tile->content) {
+				sf::Uint32 id = object->ID();
+				ar & id;
+			}
+		}
+	}
+}
+
+void WorldSnapshot::serializeLocales(World *world, uf::Archive &ar) {
+	Map *map = world->GetMap();
+	Atmos *atmos = map->GetAtmos();
+	apos size = map->GetSize();
+	bool loading = ar.IsOutput();
+
+	std::vector<Locale *> locales;
+	if (!loading)
+		for (auto &locale : atmos->locales)
+			if (!locale->IsEmpty())
+				locales.push_back(locale.get());
+
+	sf::Uint32 count = sf::Uint32(locales.size());
+	ar & count;
+	for (sf::Uint32 i = 0; i < count; i++) {
+		Locale *locale = loading ? nullptr : locales[i];
+
+		sf::Uint32 tilesCount = loading ? 0 : locale->NumOfTiles();
+		ar & tilesCount;
+		if (loading) {
+			if (!tilesCount)
+				throw std::exception(); // "Empty locale"
+			for (sf::Uint32 j = 0; j < tilesCount; j++) {
+				sf::Uint32 index;
+				ar & index;
+				Tile *tile = map->GetTile(positionOf(index, size));
+				if (!tile || tile->GetLocale())
+					throw std::exception(); // "Locale tiles are broken"
+				if (!locale) {
+					locale = atmos->CreateLocale(tile);
+				} else {
+					locale->AddTile(tile);
+				}
+			}
+		} else {
+			for (auto *tile : locale->tiles) {
+				sf::Uint32 index = sf::Uint32(uf::flat_index(tile->GetPos(), size.x, size.y));
+				ar & index;
+			}
+		}
+
+		GasMixture &mixture = locale->mix();
+		for (int gas = 0; gas < int(Gas::Count); gas++)
+			ar & mixture.gases[gas];
+		// Closeness isn't stored, breaches are counted as the tiles are added
+	}
+}
+
+void WorldSnapshot::serializeWorld(World *world, uf::Archive &ar) {
+	sf::Uint32 testMobId = world->testMob ? world->testMob->ID() : 0;
+	ar & testMobId;
+	if (ar.IsOutput()) {
+		world->testMob = dynamic_cast<Creature *>(world->GetObject(testMobId));
+		if (!world->testMob)
+			throw std::exception(); // "Test mob is missing"
+	}
+	world->testMob->serializeReference(ar, world->testMob_lastPosition);
+	ar & world->test_dx & world->test_dy;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+#include <SFML/Network/Packet.hpp>
+
+#include <Shared/Types.hpp>
+#include <Shared/Network/Archive.h>
+
+class World;
+class Object;
+class ObjectHolder;
+
+// Binary image of the world: objects with their state, free IDs, map tiles and atmos locales,
+// and which chunks of the map file are materialized.
+// Taking a snapshot is a single pass over the world, so it's done between ticks:
+// the game serializes the world in the background while it waits for the next tick.
+class WorldSnapshot {
+public:
+	// World must not change during the call. The game calls it from a background task between ticks,
+	// and the next tick waits for it in Game::waitSnapshotTaken, so game thread only state is safe to read.
+	static void Save(World *world, sf::Packet &packet);
+	// World must be just constructed, without objects.
+	// False if the snapshot is broken or doesn't fit the world, then the world should be dropped.
+	static bool Load(World *world, sf::Packet &packet);
+
+	// Data is protected with checksum. Previous file is replaced only when the new one is written.
+	static bool WriteFile(const std::string &path, const sf::Packet &packet);
+	// False if there is no file or it's broken
+	static bool ReadFile(const std::string &path, sf::Packet &packet);
+
+private:
+	struct ObjectType {
+		std::type_index type;
+		std::function<Object *(ObjectHolder *, uint id)> restore;
+	};
+
+	template<typename T, typename... TArgs>
+	static ObjectType objectType(TArgs... args);
+	static const std::vector<ObjectType> &objectTypes();
+
+	static void serializeChunks(World *world, uf::Archive &ar);
+	static void serializeObjects(World *world, uf::Archive &ar);
+	static void serializeTiles(World *world, uf::Archive &ar);
+	static void serializeLocales(World *world, uf::Archive &ar);
+	static void serializeWorld(World *world, uf::Archive &ar);
+};
@@ -0,0 +1,172 @@
+#include <World/Atmos/Atmos.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <World/World.hpp>
+#include <World/Map.hpp>
+#include <World/Tile.hpp>
+#include <World/Atmos/Locale.hpp>
+#include <World/Objects/Turfs/Floor.hpp>
+#include <World/Objects/Turfs/Wall.hpp>
+
+namespace {
+    const sf::Time TICK = sf::seconds(0.05f);
+
+    // Row of floor in open space, so every tile of it leaks
+    struct Corridor {
+        World world;
+        std::vector<Floor *> floors;
+
+        Corridor() {
+            for (uint x = 10; x < 15; x++)
+                floors.push_back(world.CreateObject<Floor>(apos(x, 10, 0)));
+            Atmos *atmos = world.GetMap()->GetAtmos();
+            world.GetMap()->ForEachTile([atmos](Tile *tile) { atmos->FillWithAir(tile); });
+        }
+
+        Tile *tile(uint x) { return world.GetMap()->GetTile(apos(x, 10, 0)); }
+        void update() { world.GetMap()->Update(TICK); }
+    };
+
+    // One room over the whole z-level
+    struct Station {
+        static const uint SIZE = 98;
+
+        World world;
+        std::vector<Floor *> floors;
+
+        Station() {
+            for (uint y = 1; y <= SIZE; y++)
+                for (uint x = 1; x <= SIZE; x++)
+                    floors.push_back(world.CreateObject<Floor>(apos(x, y, 0)));
+            Atmos *atmos = world.GetMap()->GetAtmos();
+            world.GetMap()->ForEachTile([atmos](Tile *tile) { atmos->FillWithAir(tile); });
+        }
+
+        Floor *floor(uint x, uint y) { return floors[(y - 1) * SIZE + x - 1]; }
+    };
+
+    struct TickTimes {
+        double mean;
+        double max;
+    };
+
+    // Time of the map update on the game thread, the rest of the tick is slept
+    TickTimes measureTicks(Map *map, uint ticks) {
+        TickTimes times = { 0, 0 };
+        for (uint i = 0; i < ticks; i++) {
+            auto start = std::chrono::steady_clock::now();
+            map->Update(TICK);
+            std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+            times.mean += elapsed.count() / ticks;
+            times.max = std::max(times.max, elapsed.count());
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return times;
+    }
+}
+
+TEST(Atmos, SplitWhileFrameIsComputedLosesOnlyVentedShare) {
+    // The same corridor without the split tells how much venting of the frame takes
+    Corridor split, whole;
+    // Tiles form the locale, its venting is submitted to the worker
+    split.update();
+    whole.update();
+    ASSERT_NE(nullptr, split.tile(10)->GetLocale());
+    ASSERT_EQ(split.tile(10)->GetLocale(), split.tile(14)->GetLocale());
+    const pressure before = split.tile(10)->GetTotalPressure();
+
+    // Breach in the middle cuts the locale in two before the frame is applied
+    split.tile(12)->RemoveObject(split.floors[2]);
+    split.update();
+    whole.update();
+    ASSERT_NE(split.tile(10)->GetLocale(), split.tile(14)->GetLocale());
+    const pressure vented = whole.tile(10)->GetTotalPressure();
+    ASSERT_LT(vented, before);
+
+    // The part keeping the mixture is vented by the share of the frame, the new part is vented by the next one
+    const pressure left = split.tile(10)->GetTotalPressure();
+    const pressure right = split.tile(14)->GetTotalPressure();
+    EXPECT_NEAR(vented, std::min(left, right), before * 1e-4f);
+    EXPECT_NEAR(before, std::max(left, right), before * 1e-4f);
+    // Total is down only by the gas of the opened tile and the vented share of the kept part
+    EXPECT_NEAR(2 * vented + 2 * before, 2 * left + 2 * right, before * 1e-3f);
+}
+
+TEST(Atmos, BreachesFollowNeighbourTiles) {
+    // Room of 3x3 floor inside walls on floor
+    World world;
+    Map *map = world.GetMap();
+    Floor *gapFloor = nullptr;
+    Wall *gapWall = nullptr;
+    for (uint y = 10; y < 15; y++)
+        for (uint x = 10; x < 15; x++) {
+            Floor *floor = world.CreateObject<Floor>(apos(x, y, 0));
+            if (x != 10 && x != 14 && y != 10 && y != 14)
+                continue;
+            Wall *wall = world.CreateObject<Wall>(apos(x, y, 0));
+            if (x == 12 && y == 10) {
+                gapFloor = floor;
+                gapWall = wall;
+            }
+        }
+    map->Update(TICK);
+    Locale *locale = map->GetTile(apos(12, 12, 0))->GetLocale();
+    ASSERT_NE(nullptr, locale);
+    EXPECT_EQ(9u, locale->NumOfTiles());
+    EXPECT_TRUE(locale->IsClosed());
+
+    // Hole in the wall opens the room, the tiles next to it see space
+    map->GetTile(apos(12, 10, 0))->RemoveObject(gapWall);
+    map->GetTile(apos(12, 10, 0))->RemoveObject(gapFloor);
+    map->Update(TICK);
+    locale = map->GetTile(apos(12, 12, 0))->GetLocale();
+    EXPECT_FALSE(locale->IsClosed());
+
+    // Patched again
+    world.CreateObject<Floor>(apos(12, 10, 0));
+    world.CreateObject<Wall>(apos(12, 10, 0));
+    map->Update(TICK);
+    EXPECT_TRUE(map->GetTile(apos(12, 12, 0))->GetLocale()->IsClosed());
+}
+
+TEST(Heat, ActiveChunksAreTheSubmittedOnes) {
+    Corridor corridor;
+    corridor.update();
+    corridor.world.GetMap()->GetHeat()->SetTemperature(corridor.tile(12), 1000);
+    // Stats are read after the map update, when the awake chunks are taken by the frame
+    corridor.update();
+    EXPECT_EQ(1u, corridor.world.GetMap()->GetHeat()->GetActiveChunksCount());
+}
+
+// Game thread cost of a fire and a hull breach on a big station.
+// Run with --gtest_also_run_disabled_tests.
+TEST(Atmos, DISABLED_BreachAndFireTickTime) {
+    Station station;
+    Map *map = station.world.GetMap();
+    // Room temperature and air everywhere, nothing to do
+    TickTimes settled = measureTicks(map, 20);
+
+    // Fire in the middle of the room
+    for (uint y = 30; y < 70; y++)
+        for (uint x = 30; x < 70; x++)
+            map->GetHeat()->SetTemperature(map->GetTile(apos(x, y, 0)), 1000);
+    TickTimes fire = measureTicks(map, 50);
+
+    // Breach of the whole wall, the room vents into space and is cut in two
+    for (uint y = 1; y <= Station::SIZE; y++) {
+        map->GetTile(apos(1, y, 0))->RemoveObject(station.floor(1, y));
+        map->GetTile(apos(50, y, 0))->RemoveObject(station.floor(50, y));
+    }
+    TickTimes breach = measureTicks(map, 50);
+
+    std::cout << "Map::Update, us (mean/max): settled " << settled.mean << "/" << settled.max <<
+        ", fire " << fire.mean << "/" << fire.max << ", breach " << breach.mean << "/" << breach.max << std::endl;
+    EXPECT_LT(map->GetAtmos()->GetSleepingLocalesCount() + map->GetAtmos()->GetActiveLocalesCount(), 3u);
+}
@@ -0,0 +1,101 @@
+#include <World/Atmos/Gases.hpp>
+
+#include <gtest/gtest.h>
+
+#include <World/World.hpp>
+#include <World/Map.hpp>
+#include <World/Tile.hpp>
+#include <World/Atmos/Atmos.hpp>
+#include <World/Atmos/Locale.hpp>
+#include <World/Objects/Turfs/Floor.hpp>
+#include <World/Objects/Turfs/Wall.hpp>
+
+namespace {
+    const sf::Time TICK = sf::seconds(0.05f);
+
+    void fillWithAir(Map *map) {
+        Atmos *atmos = map->GetAtmos();
+        map->ForEachTile([atmos](Tile *tile) { atmos->FillWithAir(tile); });
+    }
+}
+
+TEST(GasMixture, LanesArePaddedAndAligned) {
+    EXPECT_EQ(32u, alignof(GasMixture));
+    EXPECT_EQ(GasMixture::LANES * sizeof(pressure), sizeof(GasMixture));
+
+    GasMixture mixture;
+    for (int lane = 0; lane < GasMixture::LANES; lane++)
+        EXPECT_EQ(0, mixture.gases[lane]);
+    mixture[Gas::Freon] = 5;
+    EXPECT_EQ(5, mixture.gases[int(Gas::Freon)]);
+}
+
+TEST(GasMixture, OperationsCoverEveryLane) {
+    GasMixture mixture, other;
+    for (int lane = 0; lane < GasMixture::LANES; lane++) {
+        mixture.gases[lane] = float(lane);
+        other.gases[lane] = 10;
+    }
+
+    mixture.Add(other);
+    mixture.Scale(0.5f);
+    pressure total = 0;
+    for (int lane = 0; lane < GasMixture::LANES; lane++) {
+        EXPECT_FLOAT_EQ((lane + 10) * 0.5f, mixture.gases[lane]);
+        total += mixture.gases[lane];
+    }
+    EXPECT_FLOAT_EQ(total, mixture.Total());
+
+    mixture.Clear();
+    EXPECT_EQ(0, mixture.Total());
+}
+
+TEST(GasMixture, ClosedRoomKeepsGasOfItsTiles) {
+    // Room of 3x3 floor inside walls
+    World world;
+    Map *map = world.GetMap();
+    for (uint y = 10; y < 15; y++)
+        for (uint x = 10; x < 15; x++) {
+            world.CreateObject<Floor>(apos(x, y, 0));
+            if (x == 10 || x == 14 || y == 10 || y == 14)
+                world.CreateObject<Wall>(apos(x, y, 0));
+        }
+    fillWithAir(map);
+
+    map->Update(TICK);
+    Tile *tile = map->GetTile(apos(12, 12, 0));
+    Locale *locale = tile->GetLocale();
+    ASSERT_NE(nullptr, locale);
+    ASSERT_EQ(9u, locale->NumOfTiles());
+    // Gas of every tile is in the mixture, spread evenly
+    EXPECT_NEAR(9 * Atmos::ONE_ATMOSPHERE, locale->GetMixture().Total(), 1e-2f);
+    EXPECT_NEAR(0.21f * Atmos::ONE_ATMOSPHERE, tile->GetPressure(Gas::Oxygen), 1e-3f);
+    EXPECT_NEAR(0.79f * Atmos::ONE_ATMOSPHERE, map->GetTile(apos(11, 13, 0))->GetPressure(Gas::Nitrogen), 1e-3f);
+
+    for (int i = 0; i < 20; i++)
+        map->Update(TICK);
+    EXPECT_NEAR(Atmos::ONE_ATMOSPHERE, tile->GetTotalPressure(), 1e-3f);
+}
+
+TEST(GasMixture, OpenLocaleVentsInProportionToBreaches) {
+    // Row of floor in open space: the end tiles have 7 space neighbours, the middle ones 6
+    World world;
+    Map *map = world.GetMap();
+    for (uint x = 10; x < 15; x++)
+        world.CreateObject<Floor>(apos(x, 10, 0));
+    fillWithAir(map);
+
+    const float keep = 1.f - Atmos::VENT_RATE * (2 * 7 + 3 * 6) / 5.f * TICK.asSeconds();
+    // Venting is computed by the atmos worker and applied on the next update
+    map->Update(TICK);
+    map->Update(TICK);
+    Tile *tile = map->GetTile(apos(12, 10, 0));
+    ASSERT_NE(nullptr, tile->GetLocale());
+    EXPECT_FALSE(tile->GetLocale()->IsClosed());
+    EXPECT_NEAR(Atmos::ONE_ATMOSPHERE * keep, tile->GetTotalPressure(), 1e-3f);
+
+    // Every gas leaks at the same rate, the air stays the same
+    map->Update(TICK);
+    EXPECT_NEAR(Atmos::ONE_ATMOSPHERE * keep * keep, tile->GetTotalPressure(), 1e-3f);
+    EXPECT_NEAR(0.21f, tile->GetPressure(Gas::Oxygen) / tile->GetTotalPressure(), 1e-4f);
+}
@@ -0,0 +1,115 @@
+#include <World/Atmos/Heat.hpp>
+
+#include <gtest/gtest.h>
+
+#include <World/World.hpp>
+#include <World/Map.hpp>
+#include <World/Tile.hpp>
+#include <World/Objects/Turfs/Floor.hpp>
+#include <World/Objects/Turfs/Wall.hpp>
+
+namespace {
+    const sf::Time TICK = sf::seconds(0.05f);
+    const temperature HOT = Heat::ROOM_TEMPERATURE + 100;
+
+    // Pair of floor tiles, the first one is hot
+    struct Pair {
+        Tile *hot;
+        Tile *cold;
+    };
+
+    Pair buildPair(World &world, apos hot, apos cold) {
+        world.CreateObject<Floor>(hot);
+        world.CreateObject<Floor>(cold);
+        Map *map = world.GetMap();
+        Pair pair = { map->GetTile(hot), map->GetTile(cold) };
+        map->GetHeat()->SetTemperature(pair.hot, HOT);
+        map->GetHeat()->SetTemperature(pair.cold, Heat::ROOM_TEMPERATURE);
+        return pair;
+    }
+
+    // Steps are computed by the atmos worker and applied on the next update
+    void step(Map *map) {
+        map->Update(TICK);
+        map->Update(TICK);
+    }
+}
+
+TEST(Heat, StencilMovesHeatBetweenFloors) {
+    World world;
+    Pair pair = buildPair(world, apos(10, 10, 0), apos(11, 10, 0));
+
+    step(world.GetMap());
+
+    // Explicit step: the difference times the conductivity and the time passes over
+    const temperature flow = Heat::FLOOR_CONDUCTIVITY * 100 * TICK.asSeconds();
+    EXPECT_NEAR(HOT - flow, pair.hot->GetTemperature(), 1e-3f);
+    EXPECT_NEAR(Heat::ROOM_TEMPERATURE + flow, pair.cold->GetTemperature(), 1e-3f);
+}
+
+TEST(Heat, WallConductsAsWorseMaterial) {
+    World world;
+    Pair pair = buildPair(world, apos(10, 10, 0), apos(11, 10, 0));
+    world.CreateObject<Wall>(apos(11, 10, 0));
+
+    step(world.GetMap());
+
+    const temperature flow = Heat::WALL_CONDUCTIVITY * 100 * TICK.asSeconds();
+    EXPECT_NEAR(HOT - flow, pair.hot->GetTemperature(), 1e-3f);
+    EXPECT_NEAR(Heat::ROOM_TEMPERATURE + flow, pair.cold->GetTemperature(), 1e-3f);
+}
+
+TEST(Heat, StencilReadsBordersOfNeighbourChunks) {
+    // Tiles in two chunks next to each other
+    World world;
+    Map *map = world.GetMap();
+    Pair pair = buildPair(world, apos(MapChunk::SIZE - 1, 10, 0), apos(MapChunk::SIZE, 10, 0));
+
+    step(map);
+
+    const temperature flow = Heat::FLOOR_CONDUCTIVITY * 100 * TICK.asSeconds();
+    EXPECT_NEAR(HOT - flow, pair.hot->GetTemperature(), 1e-3f);
+    EXPECT_NEAR(Heat::ROOM_TEMPERATURE + flow, pair.cold->GetTemperature(), 1e-3f);
+    EXPECT_EQ(2u, map->GetHeat()->GetActiveChunksCount());
+}
+
+TEST(Heat, VacuumInsulates) {
+    World world;
+    Map *map = world.GetMap();
+    world.CreateObject<Floor>(apos(10, 10, 0));
+    Tile *tile = map->GetTile(apos(10, 10, 0));
+    map->GetHeat()->SetTemperature(tile, HOT);
+    // Space keeps its temperature
+    map->GetHeat()->SetTemperature(map->GetTile(apos(11, 10, 0)), HOT);
+
+    step(map);
+
+    EXPECT_EQ(HOT, tile->GetTemperature());
+    EXPECT_EQ(Heat::SPACE_TEMPERATURE, map->GetTile(apos(11, 10, 0))->GetTemperature());
+    EXPECT_EQ(0u, map->GetHeat()->GetActiveChunksCount());
+}
+
+TEST(Heat, SettledChunksSleep) {
+    World world;
+    Map *map = world.GetMap();
+    Pair pair = buildPair(world, apos(10, 10, 0), apos(11, 10, 0));
+
+    int ticks = 0;
+    do {
+        map->Update(TICK);
+        ticks++;
+    } while (map->GetHeat()->GetActiveChunksCount() && ticks < 100);
+
+    EXPECT_EQ(0u, map->GetHeat()->GetActiveChunksCount());
+    // Heat is conserved, the pair meets in the middle
+    const temperature middle = Heat::ROOM_TEMPERATURE + 50;
+    EXPECT_NEAR(middle, pair.hot->GetTemperature(), 0.05f);
+    EXPECT_NEAR(middle, pair.cold->GetTemperature(), 0.05f);
+    EXPECT_NEAR(2 * middle, pair.hot->GetTemperature() + pair.cold->GetTemperature(), 1e-3f);
+
+    // Heat source wakes the chunk again
+    map->GetHeat()->SetTemperature(pair.hot, HOT);
+    step(map);
+    EXPECT_EQ(1u, map->GetHeat()->GetActiveChunksCount());
+    EXPECT_LT(pair.hot->GetTemperature(), HOT);
+}
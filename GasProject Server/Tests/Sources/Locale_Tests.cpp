@@ -0,0 +1,239 @@
+#include <World/Atmos/Locale.hpp>
+
+#include <gtest/gtest.h>
+
+#include <World/World.hpp>
+#include <World/Map.hpp>
+#include <World/Tile.hpp>
+#include <World/Atmos/Atmos.hpp>
+#include <World/Objects/Turfs/Floor.hpp>
+#include <World/Objects/Turfs/Wall.hpp>
+#include <World/Objects/Turfs/Airlock.hpp>
+
+namespace {
+    const sf::Time TICK = sf::seconds(0.05f);
+    const float EPS = 1e-3f;
+
+    // Floor from (x0, y0) to (x1, y1) inclusive, surrounded by walls standing on it
+    void buildRoom(World &world, uint x0, uint y0, uint x1, uint y1) {
+        for (uint y = y0; y <= y1; y++)
+            for (uint x = x0; x <= x1; x++) {
+                world.CreateObject<Floor>(apos(x, y, 0));
+                if (x == x0 || x == x1 || y == y0 || y == y1)
+                    world.CreateObject<Wall>(apos(x, y, 0));
+            }
+    }
+
+    // Air on the tiles left of the given x
+    void fillWithAir(Map *map, uint beforeX = uint(-1)) {
+        Atmos *atmos = map->GetAtmos();
+        map->ForEachTile([atmos, beforeX](Tile *tile) {
+            if (tile->GetPos().x < beforeX)
+                atmos->FillWithAir(tile);
+        });
+    }
+
+    void removeWall(Map *map, uint x, uint y) {
+        Tile *tile = map->GetTile(apos(x, y, 0));
+        for (auto *object : std::vector<Object *>(tile->Content().begin(), tile->Content().end()))
+            if (object->Is(ObjectKind::Wall))
+                object->Delete();
+    }
+
+    Locale *localeAt(Map *map, uint x, uint y) {
+        return map->GetTile(apos(x, y, 0))->GetLocale();
+    }
+}
+
+TEST(Locale, WallCutsRoomInTwo) {
+    World world;
+    Map *map = world.GetMap();
+    buildRoom(world, 10, 10, 16, 14);
+    fillWithAir(map);
+    map->Update(TICK);
+    ASSERT_EQ(15u, localeAt(map, 11, 11)->NumOfTiles());
+
+    // Column of 1 tile on the left, of 3 tiles on the right
+    for (uint y = 11; y <= 13; y++)
+        world.CreateObject<Wall>(apos(12, y, 0));
+    map->Update(TICK);
+
+    Locale *left = localeAt(map, 11, 12);
+    Locale *right = localeAt(map, 15, 12);
+    ASSERT_NE(nullptr, left);
+    ASSERT_NE(nullptr, right);
+    ASSERT_NE(left, right);
+    EXPECT_EQ(nullptr, localeAt(map, 12, 12));
+    EXPECT_EQ(3u, left->NumOfTiles());
+    EXPECT_EQ(9u, right->NumOfTiles());
+    // Every part takes gas by its volume, gas of the new walls is lost
+    EXPECT_NEAR(3 * Atmos::ONE_ATMOSPHERE, left->GetMixture().Total(), 1e-2f);
+    EXPECT_NEAR(9 * Atmos::ONE_ATMOSPHERE, right->GetMixture().Total(), 1e-2f);
+    EXPECT_NEAR(Atmos::ONE_ATMOSPHERE, left->GetTotalPressure(), EPS);
+    EXPECT_NEAR(Atmos::ONE_ATMOSPHERE, right->GetTotalPressure(), EPS);
+    EXPECT_TRUE(left->IsClosed());
+    EXPECT_TRUE(right->IsClosed());
+}
+
+TEST(Locale, CutRingDoesNotSplit) {
+    // 5x5 room around a pillar
+    World world;
+    Map *map = world.GetMap();
+    buildRoom(world, 10, 10, 16, 16);
+    world.CreateObject<Wall>(apos(13, 13, 0));
+    fillWithAir(map);
+    map->Update(TICK);
+    Locale *locale = localeAt(map, 11, 11);
+    ASSERT_EQ(24u, locale->NumOfTiles());
+
+    // The ring is cut on one side only, it's still connected around the pillar
+    for (uint y = 11; y < 13; y++)
+        world.CreateObject<Wall>(apos(13, y, 0));
+    map->Update(TICK);
+
+    EXPECT_EQ(locale, localeAt(map, 12, 11));
+    EXPECT_EQ(locale, localeAt(map, 14, 11));
+    EXPECT_EQ(22u, locale->NumOfTiles());
+    EXPECT_NEAR(Atmos::ONE_ATMOSPHERE, locale->GetTotalPressure(), EPS);
+}
+
+TEST(Locale, AirlockSplitsAndMergesRooms) {
+    // Two 3x3 rooms, the airlock in the wall between them
+    World world;
+    Map *map = world.GetMap();
+    buildRoom(world, 10, 10, 14, 14);
+    buildRoom(world, 14, 10, 18, 14);
+    removeWall(map, 14, 12);
+    Tile *door = map->GetTile(apos(14, 12, 0));
+    Airlock *airlock = world.CreateObject<Airlock>(door->GetPos());
+    // Air in the left room only
+    fillWithAir(map, 14);
+
+    // The opening animation isn't played, the airlock lets air through at once
+    airlock->SetAirtight(false);
+    map->Update(TICK);
+    Locale *both = localeAt(map, 12, 12);
+    ASSERT_EQ(19u, both->NumOfTiles());
+    EXPECT_EQ(both, localeAt(map, 16, 12));
+    EXPECT_NEAR(9 * Atmos::ONE_ATMOSPHERE, both->GetMixture().Total(), 1e-2f);
+
+    airlock->SetAirtight(true);
+    map->Update(TICK);
+    Locale *left = localeAt(map, 12, 12);
+    Locale *right = localeAt(map, 16, 12);
+    ASSERT_NE(left, right);
+    EXPECT_EQ(nullptr, door->GetLocale());
+    EXPECT_EQ(9u, left->NumOfTiles());
+    EXPECT_EQ(9u, right->NumOfTiles());
+    const pressure shared = Atmos::ONE_ATMOSPHERE * 9 / 19;
+    EXPECT_NEAR(shared, left->GetTotalPressure(), EPS);
+    EXPECT_NEAR(shared, right->GetTotalPressure(), EPS);
+
+    airlock->SetAirtight(false);
+    map->Update(TICK);
+    both = localeAt(map, 12, 12);
+    EXPECT_EQ(both, localeAt(map, 16, 12));
+    EXPECT_EQ(both, door->GetLocale());
+    EXPECT_EQ(19u, both->NumOfTiles());
+    // Gas of both rooms is kept, the door tile had none
+    EXPECT_NEAR(18 * shared, both->GetMixture().Total(), 1e-2f);
+}
+
+TEST(Locale, BreachesAreRecountedOnEveryPart) {
+    // Hole in the right wall of the room
+    World world;
+    Map *map = world.GetMap();
+    buildRoom(world, 10, 10, 16, 14);
+    removeWall(map, 16, 12);
+    fillWithAir(map);
+    map->Update(TICK);
+    ASSERT_FALSE(localeAt(map, 11, 12)->IsClosed());
+
+    for (uint y = 11; y <= 13; y++)
+        world.CreateObject<Wall>(apos(13, y, 0));
+    map->Update(TICK);
+
+    // The part behind the new wall is sealed, the part with the hole still leaks
+    Locale *left = localeAt(map, 11, 12);
+    Locale *right = localeAt(map, 15, 12);
+    ASSERT_NE(left, right);
+    EXPECT_TRUE(left->IsClosed());
+    EXPECT_FALSE(right->IsClosed());
+    const pressure leftPressure = left->GetTotalPressure();
+    const pressure rightPressure = right->GetTotalPressure();
+
+    for (int i = 0; i < 10; i++)
+        map->Update(TICK);
+    EXPECT_NEAR(leftPressure, left->GetTotalPressure(), EPS);
+    EXPECT_LT(right->GetTotalPressure(), rightPressure);
+}
+
+TEST(Locale, SettledRoomFallsAsleep) {
+    World world;
+    Map *map = world.GetMap();
+    Atmos *atmos = map->GetAtmos();
+    buildRoom(world, 10, 10, 14, 14);
+    fillWithAir(map);
+    map->Update(TICK);
+    Locale *locale = localeAt(map, 12, 12);
+    EXPECT_TRUE(locale->IsAwake());
+
+    // A closed room has nothing to exchange, it sleeps once it has been left alone for long enough
+    int ticks = 1;
+    while (locale->IsAwake() && ticks < 100) {
+        map->Update(TICK);
+        ticks++;
+    }
+    EXPECT_FALSE(locale->IsAwake());
+    EXPECT_GE(TICK * sf::Int64(ticks), Atmos::SETTLE_TIME);
+    EXPECT_EQ(0u, atmos->GetActiveLocalesCount());
+    EXPECT_EQ(1u, atmos->GetSleepingLocalesCount());
+    EXPECT_NEAR(Atmos::ONE_ATMOSPHERE, locale->GetTotalPressure(), EPS);
+}
+
+TEST(Locale, VentingRoomStaysAwake) {
+    World world;
+    Map *map = world.GetMap();
+    buildRoom(world, 10, 10, 14, 14);
+    removeWall(map, 14, 12);
+    fillWithAir(map);
+
+    // Pressure falls by 1 - VENT_RATE * 3 / 10 * TICK every tick, it takes long to get below the equilibrium gradient
+    for (int i = 0; i < 100; i++)
+        map->Update(TICK);
+    Locale *locale = localeAt(map, 12, 12);
+    EXPECT_FALSE(locale->IsClosed());
+    EXPECT_TRUE(locale->IsAwake());
+    EXPECT_EQ(1u, map->GetAtmos()->GetActiveLocalesCount());
+}
+
+TEST(Locale, GasSourceAndTileChangesWakeLocale) {
+    World world;
+    Map *map = world.GetMap();
+    Atmos *atmos = map->GetAtmos();
+    buildRoom(world, 10, 10, 16, 14);
+    fillWithAir(map);
+    for (int i = 0; i < 100; i++)
+        map->Update(TICK);
+    Locale *locale = localeAt(map, 12, 12);
+    ASSERT_FALSE(locale->IsAwake());
+
+    // Added amount is spread over 15 tiles
+    atmos->AddGas(map->GetTile(apos(12, 12, 0)), Gas::Plasma, 15);
+    EXPECT_TRUE(locale->IsAwake());
+    map->Update(TICK);
+    EXPECT_EQ(1u, atmos->GetActiveLocalesCount());
+    EXPECT_NEAR(1, locale->GetPressure(Gas::Plasma), EPS);
+
+    for (int i = 0; i < 100; i++)
+        map->Update(TICK);
+    ASSERT_FALSE(locale->IsAwake());
+
+    // Wall in the middle of the room: both parts are awake until they settle
+    world.CreateObject<Wall>(apos(13, 12, 0));
+    map->Update(TICK);
+    EXPECT_TRUE(locale->IsAwake());
+    EXPECT_EQ(14u, locale->NumOfTiles());
+    EXPECT_EQ(1u, atmos->GetActiveLocalesCount());
+    EXPECT_EQ(0u, atmos->GetSleepingLocalesCount());
+}
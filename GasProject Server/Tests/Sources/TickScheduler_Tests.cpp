@@ -0,0 +1,113 @@
+#include <TickScheduler.hpp>
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+    // 20ms step is coarse enough for the sleep precision of any OS
+    const uint TICKS_PER_SECOND = 50;
+    const sf::Time STEP = sf::milliseconds(20);
+    // How late a thread may wake up or how long back-to-back ticks may take
+    const sf::Time JITTER = sf::milliseconds(8);
+
+    struct Ticks {
+        std::vector<sf::Time> starts; // since the first tick
+        std::vector<sf::Time> timesteps;
+        TickStats stats;
+    };
+
+    // Runs the given number of ticks, the first one takes stall time
+    Ticks run(TickScheduler &scheduler, size_t ticks, sf::Time stall) {
+        Ticks result;
+        std::atomic<bool> active(true);
+        sf::Clock clock;
+        scheduler.Run(active, [&](sf::Time timestep) {
+            if (result.starts.empty())
+                clock.restart();
+            result.starts.push_back(clock.getElapsedTime());
+            result.timesteps.push_back(timestep);
+            if (result.starts.size() == 1)
+                sf::sleep(stall);
+            if (result.starts.size() == ticks)
+                active = false;
+        });
+        result.stats = scheduler.GetStats();
+        return result;
+    }
+}
+
+TEST(TickScheduler, TicksAdvanceByFixedStep) {
+    TickScheduler scheduler(TICKS_PER_SECOND);
+    EXPECT_EQ(STEP, scheduler.GetTimestep());
+
+    Ticks result = run(scheduler, 10, sf::Time::Zero);
+
+    for (sf::Time timestep : result.timesteps)
+        EXPECT_EQ(STEP, timestep);
+    // Ticks are scheduled from the start, so late wake ups don't accumulate
+    for (size_t i = 1; i < result.starts.size(); i++) {
+        EXPECT_GE(result.starts[i], STEP * sf::Int64(i) - sf::milliseconds(1));
+        EXPECT_LE(result.starts[i], STEP * sf::Int64(i) + JITTER);
+    }
+    EXPECT_EQ(10u, result.stats.ticks);
+    EXPECT_EQ(0u, result.stats.overruns);
+    EXPECT_EQ(0u, result.stats.skipped);
+}
+
+TEST(TickScheduler, CatchUpRunsNotMoreThanMaxCatchUpTicks) {
+    const uint maxCatchUp = 3;
+    TickScheduler scheduler(TICKS_PER_SECOND, TickOverrunPolicy::CatchUp, maxCatchUp);
+
+    // First tick takes 15 steps, so 14 ticks are missed
+    Ticks result = run(scheduler, 8, STEP * sf::Int64(15));
+
+    // Missed ticks and the due one run back-to-back right after the stall...
+    for (size_t i = 2; i <= maxCatchUp + 1; i++)
+        EXPECT_LE(result.starts[i] - result.starts[1], JITTER) << "tick " << i;
+    // ...then the ticks follow the schedule again
+    EXPECT_GE(result.starts[maxCatchUp + 2] - result.starts[maxCatchUp + 1], STEP - JITTER);
+
+    EXPECT_EQ(1u, result.stats.overruns);
+    EXPECT_EQ(14u - maxCatchUp, result.stats.skipped);
+    EXPECT_EQ(8u, result.stats.ticks);
+}
+
+TEST(TickScheduler, CatchUpDropsBacklogAfterLongStall) {
+    const uint maxCatchUp = 5;
+    TickScheduler scheduler(TICKS_PER_SECOND, TickOverrunPolicy::CatchUp, maxCatchUp);
+
+    // Like a debugger pause, a second behind
+    Ticks result = run(scheduler, 10, sf::seconds(1));
+
+    // The second is not caught up, the server resumes its normal pace
+    EXPECT_EQ(50u - 1 - maxCatchUp, result.stats.skipped);
+    EXPECT_GE(result.starts[maxCatchUp + 2] - result.starts[maxCatchUp + 1], STEP - JITTER);
+    EXPECT_LE(result.starts.back(), sf::seconds(1) + STEP * sf::Int64(3) + JITTER);
+}
+
+TEST(TickScheduler, SkipDropsAllMissedTicks) {
+    TickScheduler scheduler(TICKS_PER_SECOND, TickOverrunPolicy::Skip);
+
+    Ticks result = run(scheduler, 4, STEP * sf::Int64(15));
+
+    // The due tick runs at once, the next one waits for its time
+    EXPECT_EQ(14u, result.stats.skipped);
+    EXPECT_LE(result.starts[1], STEP * sf::Int64(15) + JITTER);
+    EXPECT_GE(result.starts[2] - result.starts[1], STEP - JITTER);
+}
+
+TEST(TickScheduler, SimulatedAndSkippedTicksCoverRealTime) {
+    TickScheduler scheduler(TICKS_PER_SECOND, TickOverrunPolicy::CatchUp, 2);
+
+    Ticks result = run(scheduler, 12, STEP * sf::Int64(7) + STEP / sf::Int64(2));
+
+    // Every step of the real time is either simulated or reported as skipped
+    TickStats stats = result.stats;
+    sf::Time accounted = STEP * sf::Int64(stats.ticks - 1 + stats.skipped);
+    EXPECT_GE(result.starts.back(), accounted - sf::milliseconds(1));
+    EXPECT_LE(result.starts.back(), accounted + JITTER);
+    for (sf::Time timestep : result.timesteps)
+        EXPECT_EQ(STEP, timestep);
+}
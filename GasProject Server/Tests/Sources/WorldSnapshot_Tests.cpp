@@ -0,0 +1,56 @@
+#include <World/WorldSnapshot.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include <World/World.hpp>
+#include <World/Map.hpp>
+#include <World/Objects/Taser.hpp>
+#include <World/Objects/Turfs/Floor.hpp>
+
+TEST(WorldSnapshot, SavedWorldIsLoaded) {
+    World world;
+    world.FillingWorld();
+    Taser *taser = world.CreateObject<Taser>(apos(50, 50, 0));
+
+    sf::Packet packet;
+    WorldSnapshot::Save(&world, packet);
+
+    World restored;
+    ASSERT_TRUE(WorldSnapshot::Load(&restored, packet));
+    Object *restoredTaser = restored.GetObject(taser->ID());
+    ASSERT_NE(nullptr, dynamic_cast<Taser *>(restoredTaser));
+    EXPECT_EQ(restored.GetMap()->GetTile(apos(50, 50, 0)), restoredTaser->GetTile());
+    EXPECT_EQ(world.GetMap()->GetTile(apos(50, 50, 0))->Content().size(),
+              restored.GetMap()->GetTile(apos(50, 50, 0))->Content().size());
+}
+
+// Time the game waits for a snapshot at most, when the world is serialized right before the next tick.
+// Run with --gtest_also_run_disabled_tests.
+TEST(WorldSnapshot, DISABLED_SaveTime) {
+    // Floor everywhere and an item on every other tile
+    World world;
+    world.FillingWorld();
+    apos size = world.GetMap()->GetSize();
+    uint objects = 0;
+    for (uint z = 0; z < size.z; z++)
+        for (uint y = 0; y < size.y; y++)
+            for (uint x = 0; x < size.x; x++) {
+                world.CreateObject<Floor>(apos(x, y, z));
+                objects++;
+                if ((x + y) % 2) {
+                    world.CreateObject<Taser>(apos(x, y, z));
+                    objects++;
+                }
+            }
+
+    auto start = std::chrono::steady_clock::now();
+    sf::Packet packet;
+    WorldSnapshot::Save(&world, packet);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "WorldSnapshot::Save of " << objects << " objects: " << elapsed.count() << " ms, "
+        << packet.getDataSize() << " bytes" << std::endl;
+}
@@ -0,0 +1,37 @@
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+#include <IServer.h>
+#include <Resources/ResourceManager.hpp>
+
+namespace {
+    // Tiles and objects look their sprites up, the rest of the server isn't needed
+    class TestServer : public IServer {
+    public:
+        Player *Authorization(const std::string &, const std::string &) const override { return nullptr; }
+        bool Registration(const std::string &, const std::string &) const override { return false; }
+        bool JoinGame(sptr<Player> &, uint) const override { return false; }
+        IGame *GetGame(uint) const override { return nullptr; }
+        std::vector<IGame *> GetGames() const override { return {}; }
+        ResourceManager *GetRM() const override { return &RM; }
+
+        mutable ResourceManager RM;
+    };
+}
+
+// Defined in Server.cpp, which isn't built into the tests
+IServer *GServer = nullptr;
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+
+    // Resources are found from the repository root, as the server finds them from its directory
+    std::filesystem::current_path(SOURCE_ROOT);
+    TestServer server;
+    if (!server.RM.Initialize())
+        return 1;
+    GServer = &server;
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,53 @@
+#include "BitGrid.hpp"
+
+#include <bitset>
+
+namespace uf {
+
+BitGrid::BitGrid() :
+	sizeX(0), sizeY(0), sizeZ(0), wordsPerRow(0)
+{ }
+
+BitGrid::BitGrid(uint sizeX, uint sizeY, uint sizeZ) : BitGrid() {
+	Resize(sizeX, sizeY, sizeZ);
+}
+
+void BitGrid::Resize(uint sizeX, uint sizeY, uint sizeZ) {
+	this->sizeX = sizeX;
+	this->sizeY = sizeY;
+	this->sizeZ = sizeZ;
+	wordsPerRow = (sizeX + WORD_BITS - 1) / WORD_BITS;
+	words.assign(size_t(wordsPerRow) * sizeY * sizeZ, 0);
+}
+
+bool BitGrid::AnyInRow(uint fromX, uint toX, uint y, uint z) const {
+	if (fromX > toX || fromX >= sizeX)
+		return false;
+	if (toX >= sizeX)
+		toX = sizeX - 1;
+
+	const Word *row = GetRow(y, z);
+	uint first = fromX / WORD_BITS;
+	uint last = toX / WORD_BITS;
+	Word firstMask = ~Word(0) << (fromX % WORD_BITS);
+	Word lastMask = ~Word(0) >> (WORD_BITS - 1 - toX % WORD_BITS);
+
+	if (first == last)
+		return row[first] & firstMask & lastMask;
+	if (row[first] & firstMask)
+		return true;
+	for (uint i = first + 1; i < last; i++)
+		if (row[i])
+			return true;
+	return row[last] & lastMask;
+}
+
+uint BitGrid::Count(uint z) const {
+	uint count = 0;
+	const Word *begin = GetRow(0, z);
+	for (const Word *word = begin; word != begin + size_t(wordsPerRow) * sizeY; word++)
+		count += uint(std::bitset<WORD_BITS>(*word).count());
+	return count;
+}
+
+} // namespace uf
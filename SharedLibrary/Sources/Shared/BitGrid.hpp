@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Shared/Types.hpp>
+
+namespace uf {
+
+// Packed 3D grid of bits. Every row is padded to whole 64-bit words,
+// so rows can be scanned or combined a word (64 cells) at a time.
+class BitGrid {
+public:
+	typedef uint64_t Word;
+	static const uint WORD_BITS = 64;
+
+	BitGrid();
+	BitGrid(uint sizeX, uint sizeY, uint sizeZ);
+
+	void Resize(uint sizeX, uint sizeY, uint sizeZ);
+
+	bool Get(uint x, uint y, uint z) const {
+		return (words[rowIndex(y, z) + x / WORD_BITS] >> (x % WORD_BITS)) & 1;
+	}
+	void Set(uint x, uint y, uint z, bool value) {
+		Word &word = words[rowIndex(y, z) + x / WORD_BITS];
+		Word bit = Word(1) << (x % WORD_BITS);
+		word = value ? word | bit : word & ~bit;
+	}
+
+	// True if any bit in [fromX, toX] of the row is set
+	bool AnyInRow(uint fromX, uint toX, uint y, uint z) const;
+	// Set bits of the z-level
+	uint Count(uint z) const;
+
+	// Words of the row, GetWordsPerRow() of them. Bits beyond sizeX are always zero.
+	const Word *GetRow(uint y, uint z) const { return words.data() + rowIndex(y, z); }
+	uint GetWordsPerRow() const { return wordsPerRow; }
+	uint GetSizeX() const { return sizeX; }
+	uint GetSizeY() const { return sizeY; }
+	uint GetSizeZ() const { return sizeZ; }
+
+private:
+	size_t rowIndex(uint y, uint z) const { return (size_t(z) * sizeY + y) * wordsPerRow; }
+
+	uint sizeX, sizeY, sizeZ;
+	uint wordsPerRow;
+	std::vector<Word> words;
+};
+
+} // namespace uf
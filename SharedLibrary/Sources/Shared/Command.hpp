@@ -35,6 +35,8 @@ struct ServerCommand {
 		COMMAND_CODE_ERROR
 	};
 
+	virtual ~ServerCommand() = default;
+
 	virtual Code GetCode() const final;
 
 protected:
@@ -76,6 +78,14 @@ struct GameJoinErrorServerCommand : public ServerCommand {
 };
 
 struct GameListServerCommand : public ServerCommand {
+	struct GameInfo {
+		int id;
+		std::string title;
+		int playersCount;
+	};
+
+	std::vector<GameInfo> games;
+
 	GameListServerCommand();
 };
 
@@ -1,8 +1,13 @@
 #include "IHasRepeatableID.h"
 
+#include <mutex>
+
+// Objects with repeatable ids are created by several games concurrently
+static std::mutex freeIDsLock;
 static std::queue<uint32_t> freeIDs;
 
 uint32_t getNextID() {
+	std::unique_lock<std::mutex> lock(freeIDsLock);
 	if (!freeIDs.empty()) {
 		auto result = freeIDs.front();
 		freeIDs.pop();
@@ -18,6 +23,7 @@ IHasRepeatableID::IHasRepeatableID() :
 { }
 
 IHasRepeatableID::~IHasRepeatableID() {
+	std::unique_lock<std::mutex> lock(freeIDsLock);
 	freeIDs.push(id);
 }
 
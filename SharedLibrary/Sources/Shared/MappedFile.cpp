@@ -0,0 +1,96 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace uf {
+
+MappedFile::MappedFile() :
+	data(nullptr), size(0)
+{ }
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string &path) {
+	Close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || !fileSize.QuadPart) {
+		CloseHandle(file);
+		return false;
+	}
+
+	// The view keeps the file mapped after handles are closed
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping)
+		return false;
+	void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!view)
+		return false;
+
+	data = static_cast<const char *>(view);
+	size = size_t(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data)
+		UnmapViewOfFile(data);
+	data = nullptr;
+	size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const std::string &path) {
+	Close();
+
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(file, &info) || !info.st_size) {
+		close(file);
+		return false;
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	void *view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (view == MAP_FAILED)
+		return false;
+
+	data = static_cast<const char *>(view);
+	size = size_t(info.st_size);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data)
+		munmap(const_cast<char *>(data), size);
+	data = nullptr;
+	size = 0;
+}
+
+#endif
+
+} // namespace uf
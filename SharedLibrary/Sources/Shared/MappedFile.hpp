@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <Shared/IFaces/INonCopyable.h>
+
+namespace uf {
+
+// Read-only memory mapping of a whole file.
+// Pages are loaded by the OS when they are first read, so untouched parts of the file cost nothing.
+class MappedFile : public INonCopyable {
+public:
+	MappedFile();
+	~MappedFile();
+
+	// False if the file doesn't exist, is empty or can't be mapped
+	bool Open(const std::string &path);
+	void Close();
+
+	bool IsOpen() const { return data != nullptr; }
+	const char *GetData() const { return data; }
+	size_t GetSize() const { return size; }
+
+private:
+	const char *data;
+	size_t size;
+};
+
+} // namespace uf
@@ -12,4 +12,15 @@ sf::Packet &operator>>(sf::Packet &packet, uf::Direction &direction) {
 	packet >> i;
 	direction = static_cast<uf::Direction>(i);
 	return packet;
-}
\ No newline at end of file
+}
+
+sf::Packet &operator<<(sf::Packet &packet, const sf::Time &time) {
+	return packet << sf::Int64(time.asMicroseconds());
+}
+
+sf::Packet &operator>>(sf::Packet &packet, sf::Time &time) {
+	sf::Int64 microseconds;
+	packet >> microseconds;
+	time = sf::microseconds(microseconds);
+	return packet;
+}
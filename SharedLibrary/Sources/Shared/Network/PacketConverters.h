@@ -1,6 +1,9 @@
 #pragma once
 
 #include <SFML/Network/Packet.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <Shared/Geometry/Vec2.hpp>
 
 namespace uf {
 enum class Direction : char;
@@ -8,3 +11,16 @@ enum class Direction : char;
 
 sf::Packet &operator<<(sf::Packet &packet, uf::Direction &direction);
 sf::Packet &operator>>(sf::Packet &packet, uf::Direction &direction);
+
+sf::Packet &operator<<(sf::Packet &packet, const sf::Time &time);
+sf::Packet &operator>>(sf::Packet &packet, sf::Time &time);
+
+template<typename T>
+sf::Packet &operator<<(sf::Packet &packet, const uf::vec2<T> &vec) {
+	return packet << vec.x << vec.y;
+}
+
+template<typename T>
+sf::Packet &operator>>(sf::Packet &packet, uf::vec2<T> &vec) {
+	return packet >> vec.x >> vec.y;
+}
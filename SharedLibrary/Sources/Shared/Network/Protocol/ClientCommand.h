@@ -40,7 +40,7 @@ DEFINE_SERIALIZABLE(GamelistRequestClientCommand, ClientCommand)
 };
 
 DEFINE_SERIALIZABLE(JoinGameClientCommand, ClientCommand)
-	int id;
+	int id = 0;
 
 	void Serialize(uf::Archive &ar) override {
 		ClientCommand::Serialize(ar);
@@ -0,0 +1,52 @@
+#include "SlabAllocator.hpp"
+
+#include <new>
+
+namespace uf {
+
+SlabAllocator::SlabAllocator(size_t blockSize, size_t alignment, size_t blocksPerSlab) :
+	alignment(alignment < alignof(void *) ? alignof(void *) : alignment),
+	blocksPerSlab(blocksPerSlab ? blocksPerSlab : 1),
+	freeList(nullptr),
+	count(0)
+{
+	// Free block has to fit the pointer to the next one, and every block has to be aligned
+	if (blockSize < sizeof(void *))
+		blockSize = sizeof(void *);
+	this->blockSize = (blockSize + this->alignment - 1) / this->alignment * this->alignment;
+}
+
+SlabAllocator::~SlabAllocator() {
+	for (void *slab : slabs)
+		::operator delete(slab, std::align_val_t(alignment));
+}
+
+void *SlabAllocator::Allocate() {
+	if (!freeList)
+		addSlab();
+	void *block = freeList;
+	freeList = *static_cast<void **>(block);
+	count++;
+	return block;
+}
+
+void SlabAllocator::Free(void *block) {
+	if (!block)
+		return;
+	*static_cast<void **>(block) = freeList;
+	freeList = block;
+	count--;
+}
+
+void SlabAllocator::addSlab() {
+	char *slab = static_cast<char *>(::operator new(blockSize * blocksPerSlab, std::align_val_t(alignment)));
+	slabs.push_back(slab);
+	// Blocks are linked backwards, so they are taken in the order of addresses
+	for (size_t i = blocksPerSlab; i-- > 0;) {
+		void *block = slab + i * blockSize;
+		*static_cast<void **>(block) = freeList;
+		freeList = block;
+	}
+}
+
+} // namespace uf
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <Shared/IFaces/INonCopyable.h>
+
+namespace uf {
+
+// Allocator of equally sized blocks. Memory is taken in slabs of many contiguous blocks,
+// freed blocks are reused first, and slabs are returned only when the allocator is destroyed.
+// Not thread safe.
+class SlabAllocator : public INonCopyable {
+public:
+	SlabAllocator(size_t blockSize, size_t alignment, size_t blocksPerSlab = 256);
+	~SlabAllocator();
+
+	void *Allocate();
+	// Block must be allocated by this allocator
+	void Free(void *block);
+
+	size_t GetBlockSize() const { return blockSize; }
+	// Blocks in use
+	size_t GetCount() const { return count; }
+	size_t GetCapacity() const { return slabs.size() * blocksPerSlab; }
+
+private:
+	void addSlab();
+
+	size_t blockSize;
+	size_t alignment;
+	size_t blocksPerSlab;
+
+	std::vector<void *> slabs;
+	void *freeList; // free blocks keep the pointer to the next one
+	size_t count;
+};
+
+} // namespace uf
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+
+namespace uf {
+
+// Vector keeping up to N elements inline, without heap allocation.
+// For short lists read much more often than changed, like contents of tiles and objects.
+// Elements are copied as raw memory, so only trivially copyable types are allowed.
+template<class T, size_t N>
+class SmallVector {
+	static_assert(std::is_trivially_copyable<T>::value, "SmallVector is for trivially copyable types only");
+	static_assert(N > 0, "SmallVector needs inline capacity");
+
+public:
+	typedef T value_type;
+	typedef T *iterator;
+	typedef const T *const_iterator;
+
+	SmallVector() : data(inlineData), count(0), capacity(N) { }
+	SmallVector(std::initializer_list<T> list) : SmallVector() {
+		for (auto &value : list)
+			push_back(value);
+	}
+	SmallVector(const SmallVector &other) : SmallVector() { *this = other; }
+	SmallVector(SmallVector &&other) noexcept : SmallVector() { *this = std::move(other); }
+	~SmallVector() {
+		if (data != inlineData)
+			delete[] data;
+	}
+
+	SmallVector &operator=(const SmallVector &other) {
+		if (this != &other) {
+			count = 0;
+			reserve(other.count);
+			std::memcpy(data, other.data, other.count * sizeof(T));
+			count = other.count;
+		}
+		return *this;
+	}
+
+	SmallVector &operator=(SmallVector &&other) noexcept {
+		if (this == &other)
+			return *this;
+		if (other.data == other.inlineData) {
+			// Nothing to steal
+			count = 0;
+			reserve(other.count);
+			std::memcpy(data, other.data, other.count * sizeof(T));
+			count = other.count;
+		} else {
+			if (data != inlineData)
+				delete[] data;
+			data = other.data;
+			count = other.count;
+			capacity = other.capacity;
+			other.data = other.inlineData;
+			other.capacity = N;
+		}
+		other.count = 0;
+		return *this;
+	}
+
+	iterator begin() { return data; }
+	iterator end() { return data + count; }
+	const_iterator begin() const { return data; }
+	const_iterator end() const { return data + count; }
+
+	size_t size() const { return count; }
+	bool empty() const { return !count; }
+	// True while elements are stored inline
+	bool is_inline() const { return data == inlineData; }
+
+	T &operator[](size_t i) { return data[i]; }
+	const T &operator[](size_t i) const { return data[i]; }
+	T &front() { return data[0]; }
+	const T &front() const { return data[0]; }
+	T &back() { return data[count - 1]; }
+	const T &back() const { return data[count - 1]; }
+
+	void reserve(size_t newCapacity) {
+		if (newCapacity <= capacity)
+			return;
+		T *newData = new T[newCapacity];
+		std::memcpy(newData, data, count * sizeof(T));
+		if (data != inlineData)
+			delete[] data;
+		data = newData;
+		capacity = newCapacity;
+	}
+
+	void push_back(const T &value) {
+		if (count == capacity)
+			reserve(capacity * 2);
+		data[count++] = value;
+	}
+
+	void pop_back() { count--; }
+
+	// Iterators after pos are invalidated
+	iterator insert(const_iterator pos, const T &value) {
+		size_t index = pos - data;
+		T copy = value; // value may refer to the vector itself
+		if (count == capacity)
+			reserve(capacity * 2);
+		std::memmove(data + index + 1, data + index, (count - index) * sizeof(T));
+		data[index] = copy;
+		count++;
+		return data + index;
+	}
+
+	// Order of the rest is kept. Iterators after pos are invalidated.
+	iterator erase(const_iterator pos) {
+		size_t index = pos - data;
+		std::memmove(data + index, data + index + 1, (count - index - 1) * sizeof(T));
+		count--;
+		return data + index;
+	}
+
+	// Memory is kept
+	void clear() { count = 0; }
+
+private:
+	T *data;
+	size_t count;
+	size_t capacity;
+	T inlineData[N];
+};
+
+} // namespace uf
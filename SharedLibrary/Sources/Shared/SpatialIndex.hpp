@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <Shared/Types.hpp>
+
+namespace uf {
+
+// Items on a 3D grid bucketed by square chunks of every z-level.
+// Range queries visit only the chunks around the range, so their cost depends on how crowded
+// the place is, not on how many items there are in the world.
+// Every item carries flags, queries skip items without any of the requested ones.
+template<class T>
+class SpatialIndex {
+public:
+	static const uint DEFAULT_CHUNK_SIZE = 16;
+
+	SpatialIndex(uint sizeX, uint sizeY, uint sizeZ, uint chunkSize = DEFAULT_CHUNK_SIZE);
+
+	// Position must be inside the grid
+	void Insert(T item, uint x, uint y, uint z, uint flags);
+	// False if there is no such item at the position
+	bool Remove(T item, uint x, uint y, uint z);
+
+	// Call callback(item, x, y) for items in [fromX, toX] x [fromY, toY] on the z-level.
+	// Flags 0 match any item.
+	template<class Callback>
+	void QueryRect(int fromX, int fromY, int toX, int toY, uint z, uint flags, Callback &&callback) const;
+	// Items not farther than radius from the center (Euclidean distance in tiles)
+	template<class Callback>
+	void QueryRadius(int x, int y, uint z, uint radius, uint flags, Callback &&callback) const;
+
+	size_t GetCount() const { return count; }
+
+private:
+	struct Entry {
+		T item;
+		uint x, y;
+		uint flags;
+	};
+
+	std::vector<Entry> &chunkAt(uint x, uint y, uint z) {
+		return chunks[(size_t(z) * chunksY + y / chunkSize) * chunksX + x / chunkSize];
+	}
+
+	uint sizeX, sizeY, sizeZ;
+	uint chunkSize;
+	uint chunksX, chunksY;
+	std::vector<std::vector<Entry>> chunks;
+	size_t count;
+};
+
+template<class T>
+SpatialIndex<T>::SpatialIndex(uint sizeX, uint sizeY, uint sizeZ, uint chunkSize) :
+	sizeX(sizeX), sizeY(sizeY), sizeZ(sizeZ),
+	chunkSize(chunkSize ? chunkSize : DEFAULT_CHUNK_SIZE),
+	count(0)
+{
+	chunksX = (sizeX + this->chunkSize - 1) / this->chunkSize;
+	chunksY = (sizeY + this->chunkSize - 1) / this->chunkSize;
+	chunks.resize(size_t(chunksX) * chunksY * sizeZ);
+}
+
+template<class T>
+void SpatialIndex<T>::Insert(T item, uint x, uint y, uint z, uint flags) {
+	chunkAt(x, y, z).push_back({ item, x, y, flags });
+	count++;
+}
+
+template<class T>
+bool SpatialIndex<T>::Remove(T item, uint x, uint y, uint z) {
+	auto &chunk = chunkAt(x, y, z);
+	for (auto &entry : chunk)
+		if (entry.item == item && entry.x == x && entry.y == y) {
+			// Order inside the chunk doesn't matter
+			entry = chunk.back();
+			chunk.pop_back();
+			count--;
+			return true;
+		}
+	return false;
+}
+
+template<class T>
+template<class Callback>
+void SpatialIndex<T>::QueryRect(int fromX, int fromY, int toX, int toY, uint z, uint flags, Callback &&callback) const {
+	if (z >= sizeZ || toX < 0 || toY < 0 || fromX >= int(sizeX) || fromY >= int(sizeY) || fromX > toX || fromY > toY)
+		return;
+	uint x0 = uint(std::max(fromX, 0)), y0 = uint(std::max(fromY, 0));
+	uint x1 = std::min(uint(toX), sizeX - 1), y1 = std::min(uint(toY), sizeY - 1);
+
+	for (uint cy = y0 / chunkSize; cy <= y1 / chunkSize; cy++)
+		for (uint cx = x0 / chunkSize; cx <= x1 / chunkSize; cx++) {
+			auto &chunk = chunks[(size_t(z) * chunksY + cy) * chunksX + cx];
+			for (auto &entry : chunk)
+				if ((!flags || (entry.flags & flags)) &&
+					entry.x >= x0 && entry.x <= x1 && entry.y >= y0 && entry.y <= y1)
+				{
+					callback(entry.item, entry.x, entry.y);
+				}
+		}
+}
+
+template<class T>
+template<class Callback>
+void SpatialIndex<T>::QueryRadius(int x, int y, uint z, uint radius, uint flags, Callback &&callback) const {
+	int r = int(radius);
+	QueryRect(x - r, y - r, x + r, y + r, z, flags, [&](T item, uint itemX, uint itemY) {
+		int dx = int(itemX) - x, dy = int(itemY) - y;
+		if (dx * dx + dy * dy <= r * r)
+			callback(item, itemX, itemY);
+	});
+}
+
+} // namespace uf
@@ -0,0 +1,93 @@
+#include "ThreadPool.hpp"
+
+namespace uf {
+
+ThreadPool::ThreadPool(uint threadsCount) :
+	job(nullptr), jobSize(0),
+	generation(0), activeWorkers(0), stopping(false),
+	nextIndex(0)
+{
+	if (!threadsCount) {
+		uint hardware = std::thread::hardware_concurrency();
+		threadsCount = hardware > 1 ? hardware - 1 : 1;
+	}
+
+	threads.reserve(threadsCount);
+	for (uint i = 0; i < threadsCount; i++)
+		threads.emplace_back(&ThreadPool::working, this);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	jobAvailable.notify_all();
+	for (auto &thread : threads)
+		thread.join();
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)> &func) {
+	if (!count)
+		return;
+
+	if (count == 1 || threads.empty()) {
+		for (size_t i = 0; i < count; i++)
+			func(i);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		job = &func;
+		jobSize = count;
+		nextIndex = 0;
+		generation++;
+	}
+	jobAvailable.notify_all();
+
+	runJob(&func, count);
+
+	// Workers which have taken the job must finish it before func goes out of scope.
+	// Late workers will see the job exhausted or the next generation.
+	std::unique_lock<std::mutex> lock(mutex);
+	jobFinished.wait(lock, [this] { return !activeWorkers; });
+	job = nullptr;
+	jobSize = 0;
+}
+
+uint ThreadPool::GetThreadsCount() const { return uint(threads.size()); }
+
+void ThreadPool::working() {
+	uint64_t seenGeneration = 0;
+	while (true) {
+		const std::function<void(size_t)> *func;
+		size_t count;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAvailable.wait(lock, [&] { return stopping || (job && generation != seenGeneration); });
+			if (stopping)
+				return;
+			seenGeneration = generation;
+			func = job;
+			count = jobSize;
+			activeWorkers++;
+		}
+
+		runJob(func, count);
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			activeWorkers--;
+		}
+		jobFinished.notify_one();
+	}
+}
+
+void ThreadPool::runJob(const std::function<void(size_t)> *func, size_t count) {
+	size_t i;
+	while ((i = nextIndex.fetch_add(1, std::memory_order_relaxed)) < count)
+		(*func)(i);
+}
+
+} // namespace uf
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Shared/Types.hpp>
+#include <Shared/IFaces/INonCopyable.h>
+
+namespace uf {
+
+// Fixed set of worker threads for fork-join stages
+class ThreadPool : public INonCopyable {
+public:
+	// threads = 0 means one worker per hardware thread except the calling one
+	explicit ThreadPool(uint threads = 0);
+	~ThreadPool();
+
+	// Call func(i) for every i in [0, count) and wait for all of them.
+	// Calling thread takes part in the work. Not reentrant.
+	void ParallelFor(size_t count, const std::function<void(size_t)> &func);
+
+	uint GetThreadsCount() const;
+
+private:
+	void working();
+	void runJob(const std::function<void(size_t)> *func, size_t count);
+
+private:
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable jobAvailable;
+	std::condition_variable jobFinished;
+
+	// Current job, protected by mutex
+	const std::function<void(size_t)> *job;
+	size_t jobSize;
+	uint64_t generation;
+	uint activeWorkers;
+	bool stopping;
+
+	std::atomic<size_t> nextIndex;
+};
+
+} // namespace uf
@@ -2,16 +2,56 @@
 
 namespace uf {
 
+Timer::Timer() :
+	wheel(nullptr),
+	deadline(0)
+{ }
+
+Timer::~Timer() {
+	Stop();
+}
+
+void Timer::Bind(TimerWheel *wheel) {
+	Stop();
+	this->wheel = wheel;
+}
+
 void Timer::Start(sf::Time time, std::function<void()> &&callback) {
-	timeLeft = time;
-	this->callback = callback;
+	this->callback = std::move(callback);
+	if (wheel)
+		wheel->schedule(this, time);
+	else
+		timeLeft = time;
+}
+
+void Timer::Stop() {
+	// Wheel may be destroyed already, then the timer isn't linked
+	if (IsLinked())
+		wheel->cancel(this);
+	timeLeft = sf::Time::Zero;
+	callback = nullptr;
 }
 
-bool Timer::IsStopped() {
+bool Timer::IsStopped() const {
+	if (wheel)
+		return !IsLinked();
 	return timeLeft == sf::Time::Zero;
 }
 
+bool Timer::NeedsUpdate() const {
+	return !wheel && timeLeft != sf::Time::Zero;
+}
+
+sf::Time Timer::GetTimeLeft() const {
+	if (wheel)
+		return IsLinked() ? wheel->timeLeft(this) : sf::Time::Zero;
+	return timeLeft;
+}
+
 bool Timer::Update(sf::Time timeElapsed) {
+	if (wheel)
+		return IsStopped();
+
 	if (timeLeft == sf::Time::Zero)
 		return true;
 
@@ -20,10 +60,17 @@ bool Timer::Update(sf::Time timeElapsed) {
 		return false;
 	} else {
 		timeLeft = sf::Time::Zero;
-		if (callback)
-			callback();
+		fire();
 		return true;
 	}
 }
 
+void Timer::fire() {
+	// Callback may start the timer again
+	auto callback = std::move(this->callback);
+	this->callback = nullptr;
+	if (callback)
+		callback();
+}
+
 } // namespace uf
@@ -4,20 +4,46 @@
 
 #include <SFML/System/Time.hpp>
 
+#include <Shared/TimerWheel.hpp>
+
 namespace uf {
 
-class Timer {
+class Timer : private detail::TimerLink {
+	friend TimerWheel;
+
 public:
+	Timer();
+	~Timer();
+
+	Timer(const Timer &) = delete;
+	Timer &operator=(const Timer &) = delete;
+
+	// Timer bound to a wheel is fired by it, unbound one needs Update calls.
+	// Stops the timer.
+	void Bind(TimerWheel *wheel);
+
 	// Start timer
 	void Start(sf::Time time, std::function<void()> &&callback = {});
+	void Stop();
 	// true if stopped
-	bool IsStopped();
-	// update timer, return true if stopped
+	bool IsStopped() const;
+	// true if the timer is running and isn't bound to a wheel
+	bool NeedsUpdate() const;
+	// Zero if stopped
+	sf::Time GetTimeLeft() const;
+	// update unbound timer, return true if stopped
 	bool Update(sf::Time timeElapsed);
 
+private:
+	// for use from TimerWheel
+	void fire();
+
 private:
 	sf::Time timeLeft;
 	std::function<void()> callback;
+
+	TimerWheel *wheel;
+	uint64_t deadline;
 };
 
 } // namespace uf
@@ -0,0 +1,146 @@
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+
+#include "Timer.h"
+
+namespace uf {
+
+namespace detail {
+
+void TimerLink::Unlink() {
+	prev->next = next;
+	next->prev = prev;
+	prev = next = this;
+}
+
+void TimerLink::LinkBefore(TimerLink *node) {
+	prev = node->prev;
+	next = node;
+	node->prev->next = this;
+	node->prev = this;
+}
+
+} // namespace detail
+
+namespace {
+
+// Move all nodes of the list to the empty sentinel
+void splice(detail::TimerLink &from, detail::TimerLink &to) {
+	if (!from.IsLinked())
+		return;
+	to.next = from.next;
+	to.prev = from.prev;
+	to.next->prev = &to;
+	to.prev->next = &to;
+	from.prev = from.next = &from;
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(sf::Time resolution) :
+	resolution(resolution),
+	now(0),
+	count(0)
+{ }
+
+TimerWheel::~TimerWheel() {
+	// Timers may outlive the wheel, leave them stopped
+	for (auto &level : slots)
+		for (auto &slot : level)
+			while (slot.IsLinked())
+				slot.next->Unlink();
+}
+
+void TimerWheel::Advance(sf::Time timeElapsed) {
+	elapsed += timeElapsed;
+	if (elapsed < resolution)
+		return;
+
+	sf::Int64 ticks = elapsed.asMicroseconds() / resolution.asMicroseconds();
+	elapsed = sf::microseconds(elapsed.asMicroseconds() % resolution.asMicroseconds());
+
+	// Nothing to fire or cascade
+	if (!count) {
+		now += ticks;
+		return;
+	}
+
+	while (ticks--)
+		tick();
+}
+
+sf::Time TimerWheel::GetResolution() const { return resolution; }
+uint TimerWheel::GetCount() const { return count; }
+
+void TimerWheel::schedule(Timer *timer, sf::Time delay) {
+	cancel(timer);
+
+	// Time since the last tick is counted too, so timer never fires before the delay
+	sf::Int64 res = resolution.asMicroseconds();
+	sf::Int64 ticks = ((delay + elapsed).asMicroseconds() + res - 1) / res;
+	timer->deadline = now + uint64_t(std::max<sf::Int64>(ticks, 1));
+	place(timer);
+	count++;
+}
+
+void TimerWheel::cancel(Timer *timer) {
+	if (!timer->IsLinked())
+		return;
+	timer->Unlink();
+	count--;
+}
+
+sf::Time TimerWheel::timeLeft(const Timer *timer) const {
+	sf::Int64 ticks = sf::Int64(timer->deadline - now);
+	return sf::microseconds(ticks * resolution.asMicroseconds()) - elapsed;
+}
+
+void TimerWheel::tick() {
+	now++;
+
+	// Move timers of the next coarse slot down when the finer level turns over
+	uint index = now & (SLOTS - 1);
+	for (uint level = 1; level < LEVELS && !index; level++) {
+		index = (now >> (SLOT_BITS * level)) & (SLOTS - 1);
+		cascade(level);
+	}
+
+	detail::TimerLink expired;
+	splice(slots[0][now & (SLOTS - 1)], expired);
+	while (expired.IsLinked()) {
+		auto *timer = static_cast<Timer *>(expired.next);
+		timer->Unlink();
+		count--;
+		timer->fire();
+	}
+}
+
+void TimerWheel::place(Timer *timer) {
+	uint64_t deadline = timer->deadline;
+	uint64_t delta = deadline - now;
+
+	uint level = 0;
+	while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1))))
+		level++;
+
+	// Too far timers wait on the last level and are placed again on cascade
+	uint64_t range = uint64_t(1) << (SLOT_BITS * LEVELS);
+	if (delta >= range)
+		deadline = now + range - 1;
+
+	uint index = (deadline >> (SLOT_BITS * level)) & (SLOTS - 1);
+	timer->LinkBefore(&slots[level][index]);
+}
+
+void TimerWheel::cascade(uint level) {
+	detail::TimerLink moved;
+	splice(slots[level][(now >> (SLOT_BITS * level)) & (SLOTS - 1)], moved);
+	while (moved.IsLinked()) {
+		auto *timer = static_cast<Timer *>(moved.next);
+		timer->Unlink();
+		place(timer);
+	}
+}
+
+} // namespace uf
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+
+#include <SFML/System/Time.hpp>
+
+#include <Shared/Types.hpp>
+#include <Shared/IFaces/INonCopyable.h>
+
+namespace uf {
+
+class Timer;
+
+namespace detail {
+
+// Link of intrusive doubly linked list. Empty list is a sentinel pointing to itself.
+struct TimerLink {
+	TimerLink *prev = this;
+	TimerLink *next = this;
+
+	bool IsLinked() const { return next != this; }
+	void Unlink();
+	// Link this before the node. Node is a list sentinel.
+	void LinkBefore(TimerLink *node);
+};
+
+} // namespace detail
+
+// Hierarchical timing wheel. Time is counted in ticks of fixed resolution.
+// Scheduling and cancellation are O(1), expiration is O(1) amortized:
+// far timers are moved to finer levels once per level.
+// Callbacks are called from Advance and may start or stop any timers.
+class TimerWheel : public INonCopyable {
+	friend Timer;
+
+public:
+	explicit TimerWheel(sf::Time resolution);
+	~TimerWheel();
+
+	// Fire every timer expired during the time
+	void Advance(sf::Time timeElapsed);
+
+	sf::Time GetResolution() const;
+	// Scheduled timers count
+	uint GetCount() const;
+
+private:
+	// for use from Timer
+	void schedule(Timer *timer, sf::Time delay);
+	void cancel(Timer *timer);
+	sf::Time timeLeft(const Timer *timer) const;
+
+	void tick();
+	void place(Timer *timer);
+	void cascade(uint level);
+
+private:
+	static constexpr uint SLOT_BITS = 6;
+	static constexpr uint SLOTS = 1 << SLOT_BITS;
+	static constexpr uint LEVELS = 4;
+
+	sf::Time resolution;
+	sf::Time elapsed; // rest of the last Advance less than resolution
+	uint64_t now;
+	uint count;
+
+	std::array<std::array<detail::TimerLink, SLOTS>, LEVELS> slots;
+};
+
+} // namespace uf
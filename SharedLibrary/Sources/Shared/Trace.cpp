@@ -0,0 +1,150 @@
+#include "Trace.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace uf {
+namespace trace {
+
+namespace {
+
+// Events per thread kept in the rolling window
+const size_t EVENTS_PER_THREAD = 16384;
+
+struct Event {
+	const char *name;
+	int64_t start;
+	int64_t duration;
+};
+
+struct ThreadBuffer {
+	uint32_t tid;
+	std::string name;
+
+	// Only the owner thread writes, lock is taken by dumping
+	std::mutex lock;
+	std::vector<Event> events;
+	size_t next = 0;
+	bool wrapped = false;
+};
+
+struct Registry {
+	std::mutex lock;
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+Registry &registry() {
+	static Registry registry;
+	return registry;
+}
+
+ThreadBuffer &threadBuffer() {
+	thread_local std::shared_ptr<ThreadBuffer> buffer;
+	if (!buffer) {
+		buffer = std::make_shared<ThreadBuffer>();
+		buffer->events.resize(EVENTS_PER_THREAD);
+
+		Registry &reg = registry();
+		std::unique_lock<std::mutex> lock(reg.lock);
+		buffer->tid = uint32_t(reg.buffers.size() + 1);
+		buffer->name = "Thread " + std::to_string(buffer->tid);
+		reg.buffers.push_back(buffer);
+	}
+	return *buffer;
+}
+
+void writeEscaped(std::ostream &stream, const std::string &string) {
+	for (char c : string) {
+		if (c == '"' || c == '\\')
+			stream << '\\';
+		stream << c;
+	}
+}
+
+} // namespace
+
+namespace detail {
+
+std::atomic<bool> enabled(false);
+
+int64_t now() {
+	static const auto epoch = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void record(const char *name, int64_t start, int64_t end) {
+	ThreadBuffer &buffer = threadBuffer();
+	std::unique_lock<std::mutex> lock(buffer.lock);
+	buffer.events[buffer.next] = { name, start, end - start };
+	if (++buffer.next == buffer.events.size()) {
+		buffer.next = 0;
+		buffer.wrapped = true;
+	}
+}
+
+} // namespace detail
+
+void SetEnabled(bool enabled) {
+	detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SetThreadName(const std::string &name) {
+	ThreadBuffer &buffer = threadBuffer();
+	std::unique_lock<std::mutex> lock(buffer.lock);
+	buffer.name = name;
+}
+
+bool DumpChromeTrace(const std::string &path) {
+	std::ofstream file(path);
+	if (!file)
+		return false;
+	WriteChromeTrace(file);
+	return bool(file);
+}
+
+void WriteChromeTrace(std::ostream &stream) {
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	{
+		Registry &reg = registry();
+		std::unique_lock<std::mutex> lock(reg.lock);
+		buffers = reg.buffers;
+	}
+
+	stream << "{\"traceEvents\":[";
+	bool first = true;
+	auto separator = [&]() {
+		if (!first)
+			stream << ",\n";
+		first = false;
+	};
+
+	for (auto &buffer : buffers) {
+		std::unique_lock<std::mutex> lock(buffer->lock);
+
+		separator();
+		stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+		       << ",\"args\":{\"name\":\"";
+		writeEscaped(stream, buffer->name);
+		stream << "\"}}";
+
+		// From the oldest to the newest
+		size_t count = buffer->wrapped ? buffer->events.size() : buffer->next;
+		size_t begin = buffer->wrapped ? buffer->next : 0;
+		for (size_t i = 0; i < count; i++) {
+			const Event &event = buffer->events[(begin + i) % buffer->events.size()];
+			separator();
+			stream << "{\"name\":\"";
+			writeEscaped(stream, event.name);
+			stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+			       << ",\"ts\":" << event.start << ",\"dur\":" << event.duration << "}";
+		}
+	}
+
+	stream << "]}\n";
+}
+
+} // namespace trace
+} // namespace uf
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+//
+// Lightweight scoped timers.
+//
+// Every thread keeps the last events in its own ring buffer, so the trace is always
+// a rolling window of the latest activity. When tracing is disabled, a probe costs
+// one relaxed atomic load, so probes may stay in production builds.
+//
+// Usage:
+//     void Map::Update(sf::Time timeElapsed) {
+//         TRACE_SCOPE("Map::Update");
+//         ...
+//     }
+//
+
+namespace uf {
+namespace trace {
+
+namespace detail {
+	extern std::atomic<bool> enabled;
+
+	int64_t now();
+	void record(const char *name, int64_t start, int64_t end);
+}
+
+inline bool IsEnabled() { return detail::enabled.load(std::memory_order_relaxed); }
+void SetEnabled(bool enabled);
+
+// Name of the calling thread in the trace
+void SetThreadName(const std::string &name);
+
+// Write recorded events in Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+// Return false if file can't be written.
+bool DumpChromeTrace(const std::string &path);
+void WriteChromeTrace(std::ostream &stream);
+
+class Scope {
+public:
+	// name should be a string literal, only the pointer is stored
+	explicit Scope(const char *name) :
+		name(IsEnabled() ? name : nullptr),
+		start(this->name ? detail::now() : 0)
+	{ }
+
+	~Scope() {
+		if (name)
+			detail::record(name, start, detail::now());
+	}
+
+	Scope(const Scope &) = delete;
+	Scope &operator=(const Scope &) = delete;
+
+private:
+	const char *name;
+	int64_t start;
+};
+
+} // namespace trace
+} // namespace uf
+
+#define _TRACE_CONCAT_IMPL(a, b) a##b
+#define _TRACE_CONCAT(a, b) _TRACE_CONCAT_IMPL(a, b)
+
+// Measure the time until the end of the current scope
+#define TRACE_SCOPE(name) uf::trace::Scope _TRACE_CONCAT(_traceScope, __LINE__)(name)
@@ -0,0 +1,39 @@
+#include <Shared/BitGrid.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(BitGrid, SetsAndClearsSingleBits) {
+    uf::BitGrid grid(130, 3, 2);
+    EXPECT_EQ(3u, grid.GetWordsPerRow());
+
+    grid.Set(0, 0, 0, true);
+    grid.Set(64, 2, 1, true);
+    grid.Set(129, 1, 1, true);
+    EXPECT_TRUE(grid.Get(0, 0, 0));
+    EXPECT_TRUE(grid.Get(64, 2, 1));
+    EXPECT_TRUE(grid.Get(129, 1, 1));
+    EXPECT_FALSE(grid.Get(63, 2, 1));
+    EXPECT_FALSE(grid.Get(0, 0, 1));
+    EXPECT_EQ(1u, grid.Count(0));
+    EXPECT_EQ(2u, grid.Count(1));
+
+    grid.Set(64, 2, 1, false);
+    EXPECT_FALSE(grid.Get(64, 2, 1));
+    EXPECT_EQ(1u, grid.Count(1));
+}
+
+TEST(BitGrid, FindsBitsInRowRanges) {
+    uf::BitGrid grid(200, 1, 1);
+    grid.Set(70, 0, 0, true);
+
+    EXPECT_TRUE(grid.AnyInRow(70, 70, 0, 0));
+    EXPECT_TRUE(grid.AnyInRow(0, 199, 0, 0));
+    EXPECT_TRUE(grid.AnyInRow(10, 150, 0, 0));
+    EXPECT_FALSE(grid.AnyInRow(0, 69, 0, 0));
+    EXPECT_FALSE(grid.AnyInRow(71, 199, 0, 0));
+    EXPECT_FALSE(grid.AnyInRow(71, 500, 0, 0));
+
+    grid.Set(199, 0, 0, true);
+    EXPECT_TRUE(grid.AnyInRow(150, 1000, 0, 0));
+    EXPECT_FALSE(grid.AnyInRow(80, 10, 0, 0));
+}
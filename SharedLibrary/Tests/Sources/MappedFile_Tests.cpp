@@ -0,0 +1,43 @@
+#include <Shared/MappedFile.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace {
+    const std::string PATH = "MappedFile_Tests.bin";
+}
+
+TEST(MappedFile, ReadsWholeFile) {
+    std::string content(10000, '\0');
+    for (size_t i = 0; i < content.size(); i++)
+        content[i] = char(i * 7);
+    {
+        std::ofstream file(PATH, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), content.size());
+    }
+
+    uf::MappedFile mapped;
+    ASSERT_TRUE(mapped.Open(PATH));
+    EXPECT_TRUE(mapped.IsOpen());
+    ASSERT_EQ(content.size(), mapped.GetSize());
+    EXPECT_EQ(content, std::string(mapped.GetData(), mapped.GetSize()));
+
+    mapped.Close();
+    EXPECT_FALSE(mapped.IsOpen());
+    EXPECT_EQ(0u, mapped.GetSize());
+    std::remove(PATH.c_str());
+}
+
+TEST(MappedFile, FailsOnMissingOrEmptyFile) {
+    uf::MappedFile mapped;
+    std::remove(PATH.c_str());
+    EXPECT_FALSE(mapped.Open(PATH));
+
+    std::ofstream(PATH, std::ios::binary | std::ios::trunc).close();
+    EXPECT_FALSE(mapped.Open(PATH));
+    EXPECT_FALSE(mapped.IsOpen());
+    std::remove(PATH.c_str());
+}
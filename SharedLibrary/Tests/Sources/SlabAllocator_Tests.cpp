@@ -0,0 +1,46 @@
+#include <Shared/SlabAllocator.hpp>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(SlabAllocator, BlocksAreAlignedAndDistinct) {
+    uf::SlabAllocator slab(40, 16, 8);
+    std::set<char *> blocks;
+    for (int i = 0; i < 20; i++) {
+        char *block = static_cast<char *>(slab.Allocate());
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % 16);
+        EXPECT_TRUE(blocks.insert(block).second);
+    }
+    EXPECT_EQ(48u, slab.GetBlockSize());
+    EXPECT_EQ(20u, slab.GetCount());
+    EXPECT_EQ(24u, slab.GetCapacity());
+
+    // Blocks don't overlap
+    char *previous = nullptr;
+    for (char *block : blocks) {
+        if (previous)
+            EXPECT_GE(block - previous, 48);
+        previous = block;
+    }
+}
+
+TEST(SlabAllocator, FreedBlocksAreReused) {
+    uf::SlabAllocator slab(sizeof(int), alignof(int), 4);
+    std::vector<void *> blocks;
+    for (int i = 0; i < 4; i++)
+        blocks.push_back(slab.Allocate());
+
+    slab.Free(blocks[1]);
+    slab.Free(blocks[3]);
+    EXPECT_EQ(2u, slab.GetCount());
+
+    EXPECT_EQ(blocks[3], slab.Allocate());
+    EXPECT_EQ(blocks[1], slab.Allocate());
+    EXPECT_EQ(4u, slab.GetCapacity());
+
+    slab.Allocate();
+    EXPECT_EQ(8u, slab.GetCapacity());
+}
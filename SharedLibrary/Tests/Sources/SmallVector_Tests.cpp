@@ -0,0 +1,116 @@
+#include <Shared/SmallVector.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+    struct Item {
+        int layer;
+        bool dense;
+    };
+
+    // The same layer-ordered insertion Tile does
+    template<class Container>
+    void insertByLayer(Container &content, Item *item) {
+        auto iter = content.begin();
+        while (iter != content.end() && (*iter)->layer <= item->layer)
+            iter++;
+        content.insert(iter, item);
+    }
+
+    template<class Container>
+    bool remove(Container &content, Item *item) {
+        for (auto iter = content.begin(); iter != content.end(); iter++)
+            if (*iter == item) {
+                content.erase(iter);
+                return true;
+            }
+        return false;
+    }
+
+    // Objects walk through a row of tiles: every step removes them from one tile, checks density
+    // of the next one and places them there
+    template<class Container>
+    double movesPerSecond(std::vector<Item> &items, size_t tilesCount, size_t steps, size_t &checksum) {
+        std::vector<Container> tiles(tilesCount);
+        std::vector<size_t> positions(items.size());
+        for (size_t i = 0; i < items.size(); i++) {
+            positions[i] = i % tilesCount;
+            insertByLayer(tiles[positions[i]], &items[i]);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t step = 0; step < steps; step++)
+            for (size_t i = 0; i < items.size(); i++) {
+                size_t next = (positions[i] + 1) % tilesCount;
+                for (auto *item : tiles[next])
+                    checksum += item->dense;
+                remove(tiles[positions[i]], &items[i]);
+                insertByLayer(tiles[next], &items[i]);
+                positions[i] = next;
+            }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return double(steps * items.size()) / elapsed.count();
+    }
+}
+
+TEST(SmallVector, KeepsOrderOnInsertAndErase) {
+    uf::SmallVector<int, 2> vector;
+    vector.push_back(1);
+    vector.push_back(3);
+    EXPECT_TRUE(vector.is_inline());
+
+    vector.insert(vector.begin() + 1, 2);
+    vector.insert(vector.end(), 4);
+    EXPECT_FALSE(vector.is_inline());
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3, 4 }), std::vector<int>(vector.begin(), vector.end()));
+
+    auto next = vector.erase(vector.begin());
+    EXPECT_EQ(2, *next);
+    vector.erase(vector.begin() + 1);
+    EXPECT_EQ(std::vector<int>({ 2, 4 }), std::vector<int>(vector.begin(), vector.end()));
+    EXPECT_EQ(2, vector.front());
+    EXPECT_EQ(4, vector.back());
+}
+
+TEST(SmallVector, CopiesAndMoves) {
+    uf::SmallVector<int, 2> small = { 1, 2 };
+    uf::SmallVector<int, 2> big = { 1, 2, 3, 4, 5 };
+
+    uf::SmallVector<int, 2> copy = big;
+    EXPECT_EQ(5u, copy.size());
+    EXPECT_EQ(5, copy[4]);
+
+    uf::SmallVector<int, 2> moved = std::move(big);
+    EXPECT_EQ(5u, moved.size());
+    EXPECT_TRUE(big.empty());
+    EXPECT_TRUE(big.is_inline());
+
+    moved = small;
+    EXPECT_EQ(std::vector<int>({ 1, 2 }), std::vector<int>(moved.begin(), moved.end()));
+    moved = std::move(small);
+    EXPECT_EQ(2u, moved.size());
+    EXPECT_TRUE(small.empty());
+}
+
+// Micro-benchmark against std::list which tiles and objects used before.
+// Run with --gtest_also_run_disabled_tests.
+TEST(SmallVector, DISABLED_MovesFasterThanList) {
+    const size_t tiles = 4096;
+    const size_t steps = 200;
+    std::vector<Item> items(tiles * 2);
+    for (size_t i = 0; i < items.size(); i++)
+        items[i] = { int(i % 5) * 10, i % 7 == 0 };
+
+    size_t listChecksum = 0, vectorChecksum = 0;
+    double list = movesPerSecond<std::list<Item *>>(items, tiles, steps, listChecksum);
+    double vector = movesPerSecond<uf::SmallVector<Item *, 4>>(items, tiles, steps, vectorChecksum);
+    std::cout << "std::list: " << list / 1e6 << " M moves/s, uf::SmallVector: " << vector / 1e6 << " M moves/s" << std::endl;
+
+    EXPECT_EQ(listChecksum, vectorChecksum);
+    EXPECT_GT(vector, list);
+}
@@ -0,0 +1,103 @@
+#include <Shared/SpatialIndex.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+    const uint CREATURE = 1;
+    const uint ITEM = 2;
+
+    struct Item {
+        uint x, y, z;
+        uint flags;
+    };
+
+    std::vector<int> collectRadius(const uf::SpatialIndex<int> &index, int x, int y, uint z, uint radius, uint flags) {
+        std::vector<int> found;
+        index.QueryRadius(x, y, z, radius, flags, [&](int item, uint, uint) { found.push_back(item); });
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+}
+
+TEST(SpatialIndex, FindsItemsInRectAndRadius) {
+    uf::SpatialIndex<int> index(100, 100, 2, 8);
+    index.Insert(1, 10, 10, 0, CREATURE);
+    index.Insert(2, 13, 14, 0, ITEM);
+    index.Insert(3, 17, 10, 0, CREATURE);
+    index.Insert(4, 10, 10, 1, CREATURE);
+    index.Insert(5, 0, 0, 0, CREATURE);
+
+    std::vector<int> found;
+    index.QueryRect(8, 8, 17, 14, 0, 0, [&](int item, uint, uint) { found.push_back(item); });
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), found);
+
+    EXPECT_EQ(std::vector<int>({ 1, 2 }), collectRadius(index, 10, 10, 0, 5, 0));
+    EXPECT_EQ(std::vector<int>({ 1 }), collectRadius(index, 10, 10, 0, 5, CREATURE));
+    EXPECT_EQ(std::vector<int>({ 1, 3 }), collectRadius(index, 10, 10, 0, 7, CREATURE));
+    EXPECT_EQ(std::vector<int>({ 4 }), collectRadius(index, 10, 10, 1, 7, 0));
+    // Range crossing the border of the grid
+    EXPECT_EQ(std::vector<int>({ 5 }), collectRadius(index, 0, 0, 0, 3, 0));
+    EXPECT_EQ(std::vector<int>(), collectRadius(index, 10, 10, 5, 100, 0));
+}
+
+TEST(SpatialIndex, RemovesItems) {
+    uf::SpatialIndex<int> index(32, 32, 1);
+    index.Insert(1, 5, 5, 0, ITEM);
+    index.Insert(2, 5, 5, 0, ITEM);
+    EXPECT_EQ(2u, index.GetCount());
+
+    EXPECT_FALSE(index.Remove(1, 6, 5, 0));
+    EXPECT_TRUE(index.Remove(1, 5, 5, 0));
+    EXPECT_FALSE(index.Remove(1, 5, 5, 0));
+    EXPECT_EQ(1u, index.GetCount());
+    EXPECT_EQ(std::vector<int>({ 2 }), collectRadius(index, 5, 5, 0, 0, 0));
+}
+
+// Items are spread with the same density over growing maps: the index query cost stays flat,
+// while the full scan grows with the population.
+// Run with --gtest_also_run_disabled_tests.
+TEST(SpatialIndex, DISABLED_QueryCostDoesntDependOnPopulation) {
+    const uint radius = 7;
+    const int queries = 2000;
+    std::mt19937 random(13);
+
+    for (uint size : { 128u, 256u, 512u, 1024u }) {
+        std::vector<Item> items(size * size / 10);
+        std::uniform_int_distribution<uint> coord(0, size - 1);
+        uf::SpatialIndex<uint> index(size, size, 1);
+        for (uint i = 0; i < items.size(); i++) {
+            items[i] = { coord(random), coord(random), 0, i % 4 ? ITEM : CREATURE };
+            index.Insert(i, items[i].x, items[i].y, 0, items[i].flags);
+        }
+
+        std::vector<std::pair<int, int>> centers(queries);
+        for (auto &center : centers)
+            center = { int(coord(random)), int(coord(random)) };
+
+        size_t indexFound = 0, scanFound = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (auto &center : centers)
+            index.QueryRadius(center.first, center.second, 0, radius, CREATURE, [&](uint, uint, uint) { indexFound++; });
+        std::chrono::duration<double, std::nano> indexTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (auto &center : centers)
+            for (auto &item : items) {
+                int dx = int(item.x) - center.first, dy = int(item.y) - center.second;
+                if ((item.flags & CREATURE) && dx * dx + dy * dy <= int(radius * radius))
+                    scanFound++;
+            }
+        std::chrono::duration<double, std::nano> scanTime = std::chrono::steady_clock::now() - start;
+
+        std::cout << size << "x" << size << ", " << items.size() << " items: index " << indexTime.count() / queries
+            << " ns/query, full scan " << scanTime.count() / queries << " ns/query" << std::endl;
+        EXPECT_EQ(scanFound, indexFound);
+    }
+}
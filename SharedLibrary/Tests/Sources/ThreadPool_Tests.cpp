@@ -0,0 +1,35 @@
+#include <Shared/ThreadPool.hpp>
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(ThreadPool, CallsEveryIndexOnce) {
+    uf::ThreadPool pool(4);
+    std::vector<std::atomic<int>> calls(1000);
+
+    pool.ParallelFor(calls.size(), [&](size_t i) { calls[i]++; });
+
+    for (auto &count : calls)
+        EXPECT_EQ(1, count);
+}
+
+TEST(ThreadPool, CanBeReusedManyTimes) {
+    uf::ThreadPool pool(3);
+    std::atomic<size_t> sum(0);
+
+    for (int run = 0; run < 200; run++)
+        pool.ParallelFor(10, [&](size_t i) { sum += i; });
+
+    EXPECT_EQ(200u * 45u, sum);
+}
+
+TEST(ThreadPool, EmptyJobDoesNothing) {
+    uf::ThreadPool pool(2);
+    bool called = false;
+
+    pool.ParallelFor(0, [&](size_t) { called = true; });
+
+    EXPECT_FALSE(called);
+}
@@ -0,0 +1,110 @@
+#include <Shared/Timer.h>
+#include <Shared/TimerWheel.hpp>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+    const sf::Time TICK = sf::milliseconds(50);
+}
+
+TEST(TimerWheel, FiresOnDeadline) {
+    uf::TimerWheel wheel(TICK);
+    uf::Timer timer;
+    timer.Bind(&wheel);
+    int fired = 0;
+
+    timer.Start(sf::milliseconds(500), [&]() { fired++; });
+    EXPECT_FALSE(timer.IsStopped());
+    EXPECT_FALSE(timer.NeedsUpdate());
+
+    for (int i = 0; i < 9; i++)
+        wheel.Advance(TICK);
+    EXPECT_EQ(0, fired);
+
+    wheel.Advance(TICK);
+    EXPECT_EQ(1, fired);
+    EXPECT_TRUE(timer.IsStopped());
+    EXPECT_EQ(0u, wheel.GetCount());
+}
+
+TEST(TimerWheel, FarTimersCascade) {
+    uf::TimerWheel wheel(TICK);
+    std::vector<sf::Int64> delays = { 1, 63, 64, 65, 4095, 4096, 70000, 17000000 };
+    std::vector<uf::Timer> timers(delays.size());
+    std::vector<sf::Int64> firedAt(delays.size(), -1);
+
+    for (size_t i = 0; i < delays.size(); i++) {
+        timers[i].Bind(&wheel);
+        timers[i].Start(sf::microseconds(TICK.asMicroseconds() * delays[i]), [&, i]() { firedAt[i] = -2; });
+    }
+
+    for (sf::Int64 tick = 1; tick <= delays.back(); tick++) {
+        wheel.Advance(TICK);
+        for (auto &at : firedAt)
+            if (at == -2)
+                at = tick;
+    }
+
+    for (size_t i = 0; i < delays.size(); i++)
+        EXPECT_EQ(delays[i], firedAt[i]);
+}
+
+TEST(TimerWheel, StoppedTimerDoesNotFire) {
+    uf::TimerWheel wheel(TICK);
+    uf::Timer timer;
+    timer.Bind(&wheel);
+    bool fired = false;
+
+    timer.Start(TICK * 3.f, [&]() { fired = true; });
+    timer.Stop();
+    wheel.Advance(TICK * 10.f);
+
+    EXPECT_FALSE(fired);
+    EXPECT_EQ(0u, wheel.GetCount());
+}
+
+TEST(TimerWheel, CallbackCanRestartTimer) {
+    uf::TimerWheel wheel(TICK);
+    uf::Timer timer;
+    timer.Bind(&wheel);
+    int fired = 0;
+
+    std::function<void()> callback = [&]() {
+        if (++fired < 3)
+            timer.Start(TICK * 2.f, std::function<void()>(callback));
+    };
+    timer.Start(TICK * 2.f, std::function<void()>(callback));
+
+    wheel.Advance(TICK * 10.f);
+
+    EXPECT_EQ(3, fired);
+    EXPECT_TRUE(timer.IsStopped());
+}
+
+TEST(TimerWheel, PartialTicksAreAccumulated) {
+    uf::TimerWheel wheel(TICK);
+    uf::Timer timer;
+    timer.Bind(&wheel);
+    bool fired = false;
+
+    timer.Start(TICK, [&]() { fired = true; });
+    wheel.Advance(TICK / 2.f);
+    EXPECT_FALSE(fired);
+    wheel.Advance(TICK / 2.f);
+    EXPECT_TRUE(fired);
+}
+
+TEST(Timer, UnboundTimerNeedsUpdates) {
+    uf::Timer timer;
+    bool fired = false;
+
+    timer.Start(TICK * 2.f, [&]() { fired = true; });
+    EXPECT_TRUE(timer.NeedsUpdate());
+
+    EXPECT_FALSE(timer.Update(TICK));
+    EXPECT_TRUE(timer.Update(TICK));
+    EXPECT_TRUE(fired);
+    EXPECT_FALSE(timer.NeedsUpdate());
+}